@@ -6,16 +6,12 @@
 #include "error_correction.h"
 #include "system_debug.h"
 #include "system_definitions.h"
+#include "protocol_data.h"
 
 // =============================================================================
-// BCH GALOIS FIELD TABLES (from bch_encoder_2g.c)
+// BCH TABLES (from bch_encoder_2g.c)
 // =============================================================================
 
-// Galois Field GF(2^6) tables for BCH(250,202)
-static uint8_t gf_exp[512];    // Exponential table (double size for modulo)
-static uint8_t gf_log[64];     // Logarithm table
-static uint8_t gf_initialized = 0;
-
 // Generator polynomial coefficients for BCH(250,202,6)
 static const uint8_t generator_poly[] = {
     1, 59, 13, 104, 189, 68, 209, 30, 8, 163, 65, 41, 229, 98, 50, 36, 59, 
@@ -32,47 +28,11 @@ const uint8_t bch_test_data_appendix_b1[202] = {
 
 const uint64_t bch_expected_parity_appendix_b1 = 0x492A4FC57A49ULL;
 
-// =============================================================================
-// GALOIS FIELD INITIALIZATION
-// =============================================================================
-
-static void init_galois_field(void) {
-    if(gf_initialized) return;
-    
-    // Primitive polynomial: x^6 + x + 1 (binary: 1000011 = 67)
-    uint8_t primitive_poly = 0x43;
-    
-    // Initialize exponential table
-    gf_exp[0] = 1;
-    for(int i = 1; i < 63; i++) {
-        gf_exp[i] = gf_exp[i-1] << 1;
-        if(gf_exp[i] & 0x40) {  // If bit 6 is set
-            gf_exp[i] ^= primitive_poly;
-        }
-    }
-    
-    // Extend table for modulo operations
-    for(int i = 63; i < 512; i++) {
-        gf_exp[i] = gf_exp[i % 63];
-    }
-    
-    // Initialize logarithm table
-    gf_log[0] = 0;  // log(0) undefined, set to 0
-    for(int i = 0; i < 63; i++) {
-        gf_log[gf_exp[i]] = i;
-    }
-    
-    gf_initialized = 1;
-    DEBUG_LOG_FLUSH("Galois Field GF(2^6) initialized\r\n");
-}
-
 // =============================================================================
 // BCH ENCODING FUNCTIONS
 // =============================================================================
 
 void calculate_bch_2g(uint8_t* info_bits, uint8_t* parity_bits) {
-    if(!gf_initialized) init_galois_field();
-    
     // Clear parity bits
     memset(parity_bits, 0, BCH_PARITY_BITS);
     
@@ -120,6 +80,28 @@ uint64_t compute_bch_250_202(const uint8_t *data_202bits) {
     return reg & 0xFFFFFFFFFFFFULL;  // Return 48 bits
 }
 
+// Parity of the packed (MSB first) information bits [first, first + count)
+// with every other bit taken as 0. The encoder is linear, so the parities of
+// disjoint spans XOR to the parity of the whole field. Leading zeros leave
+// the register at 0 and are skipped
+uint64_t compute_bch_250_202_span(const uint8_t *info_packed, uint16_t first, uint16_t count) {
+    const uint64_t g = 0x1C7EB85DF3C97ULL;  // Same register as compute_bch_250_202
+    uint16_t end = first + count;
+    
+    uint64_t reg = 0;
+    
+    for (uint16_t i = first; i < BCH_N; i++) {
+        uint8_t bit = (i < end) ? (info_packed[i >> 3] >> (7 - (i & 7))) & 1 : 0;
+        uint8_t msb = (reg >> 48) & 1;
+        
+        reg = ((reg << 1) | bit) & 0x1FFFFFFFFFFFFULL;
+        
+        if (msb) reg ^= g;
+    }
+    
+    return reg & 0xFFFFFFFFFFFFULL;
+}
+
 void encode_bch_2g_with_correction(uint8_t* info_bits, uint8_t* codeword) {
     // Build complete codeword
     memcpy(codeword, info_bits, BCH_K);
@@ -152,8 +134,8 @@ uint8_t test_bch_encoder_2g(void) {
     DEBUG_LOG_FLUSH("Testing BCH encoder...\r\n");
     
     // Test with known vector
-    uint8_t test_info[202];
-    memcpy(test_info, bch_test_data_appendix_b1, 202);
+    uint8_t *test_info = frame_arena.shared.selftest.bch_info;
+    memcpy(test_info, bch_test_data_appendix_b1, INFO_BITS);
     
     uint64_t computed_bch = compute_bch_250_202(test_info);
     uint64_t expected_bch = bch_expected_parity_appendix_b1;
@@ -204,8 +186,6 @@ uint8_t verify_bch_integrity(const uint8_t *frame_252bits) {
 // =============================================================================
 
 void calculate_syndrome_2g(uint8_t* received_bits, uint8_t* syndrome) {
-    if(!gf_initialized) init_galois_field();
-    
     memset(syndrome, 0, BCH_PARITY_BITS);
     
     // Calculate syndrome for error detection
@@ -257,6 +237,23 @@ uint8_t count_bch_errors(const uint8_t *received_bits, const uint8_t *expected_b
     return error_count;
 }
 
+// =============================================================================
+// CRC
+// =============================================================================
+
+uint16_t crc16_ccitt_words(const uint16_t* words, uint16_t count) {
+    uint16_t crc = 0xFFFF;
+    
+    for(uint16_t i = 0; i < count; i++) {
+        crc ^= words[i];
+        for(uint8_t bit = 0; bit < 16; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    
+    return crc;
+}
+
 // =============================================================================
 // DEBUG FUNCTIONS
 // =============================================================================
@@ -18,6 +18,7 @@
 // BCH encoder functions
 void calculate_bch_2g(uint8_t* info_bits, uint8_t* parity_bits);
 uint64_t compute_bch_250_202(const uint8_t *data_202bits);
+uint64_t compute_bch_250_202_span(const uint8_t *info_packed, uint16_t first, uint16_t count);
 void encode_bch_2g_with_correction(uint8_t* info_bits, uint8_t* codeword);
 
 // BCH verification and testing
@@ -33,6 +34,9 @@ void calculate_syndrome_2g(uint8_t* received_bits, uint8_t* syndrome);
 uint8_t decode_bch_250_202(uint8_t *received_250bits, uint8_t *corrected_202bits);
 uint8_t count_bch_errors(const uint8_t *received_bits, const uint8_t *expected_bits);
 
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over 16-bit words, MSB first
+uint16_t crc16_ccitt_words(const uint16_t* words, uint16_t count);
+
 // Debug functions
 void debug_print_bch_parity(uint8_t* parity_bits);
 
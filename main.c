@@ -11,11 +11,29 @@
 #include "error_correction.h"
 
 // External declarations
-extern volatile uint32_t millis_counter;
 extern volatile tx_phase_t tx_phase;
 
 // Global variables
-static uint32_t last_tx_time = 0;
+static beacon_frame_type_2g_t frame_type;
+static uint32_t tx_deadline_us = 0;
+
+// Startup timing (us since the time base started, ~reset)
+static uint32_t ready_time_us = 0;
+static uint8_t boot_timing_reported = 0;
+
+// CPU duty cycle per burst cycle (burst start to next burst start)
+static uint32_t cycle_start_us = 0;
+static uint32_t cycle_idle_start_us = 0;
+static uint8_t cycle_phase = 0;         // 0 = TEST, 1-3 = ELT phase
+
+// Rotating field cycle per mode (system_definitions.h)
+static const rotating_field_type_2g_t rf_cycle_test[] = RF_CYCLE_TEST;
+static const rotating_field_type_2g_t rf_cycle_exercise[] = RF_CYCLE_EXERCISE;
+
+// Scheduler job periods
+#define GPS_SERVICE_PERIOD_US   20000UL     // 512-byte RX ring holds ~0.5 s at 9600 bd
+#define STATUS_LED_PERIOD_US    500000UL    // Heartbeat
+#define RF_STATUS_PERIOD_US     100000UL
 
 // Function declarations
 void start_beacon_frame_2g(beacon_frame_type_2g_t frame_type);
@@ -26,22 +44,193 @@ beacon_frame_type_2g_t get_frame_type_from_switch(void) {
     return MODE_SWITCH_PORT ? BEACON_EXERCISE_FRAME_2G : BEACON_TEST_FRAME_2G;
 }
 
-uint8_t should_transmit_beacon(void) {
-    uint32_t current_millis;
-    uint32_t last_tx;
+// Interval to the next burst in us, drawn once per burst (after the ELT phase update)
+static uint32_t next_tx_interval_us(void) {
+    if(frame_type == BEACON_TEST_FRAME_2G) {
+        return tx_interval_ms * 1000UL;
+    }
+    return get_current_interval_2g() * 1000UL;
+}
+
+// =============================================================================
+// POWER-ON SELF-TESTS (results cached in the configuration store)
+// =============================================================================
+
+#define POST_FLAG_PRN           0x0001
+#define POST_FLAG_BCH           0x0002
+#define POST_FLAG_POSITION      0x0004
+#define POST_FLAG_CHIP_CLOCK    0x0008
+#define POST_FLAG_ELT_RNG       0x0080
+#define POST_ALL_PASSED         (POST_FLAG_PRN | POST_FLAG_BCH | POST_FLAG_POSITION | POST_FLAG_CHIP_CLOCK | \
+                                 POST_FLAG_ELT_RNG)
+
+// POST record payload layout
+#define POST_REC_HASH_LO        0
+#define POST_REC_HASH_HI        1
+#define POST_REC_FLAGS          2
+#define POST_REC_I_OFFSET       3
+#define POST_REC_Q_OFFSET       4
+#define POST_REC_I_GAIN         5       // 2 words (raw float)
+#define POST_REC_Q_GAIN         7       // 2 words (raw float)
+
+static uint16_t run_self_tests(void) {
+    uint16_t flags = 0;
     
-    // Atomic read of shared variables
-    __builtin_disable_interrupts();
-    current_millis = millis_counter;
-    last_tx = last_tx_time;
-    __builtin_enable_interrupts();
+    // Verify PRN sequences
+    if(verify_prn_sequence(PRN_MODE_NORMAL)) {
+        flags |= POST_FLAG_PRN;
+    } else {
+        DEBUG_LOG_FLUSH("WARNING: PRN sequence verification failed\r\n");
+    }
+    
+    // Test BCH encoder
+    if(test_bch_encoder_2g()) {
+        flags |= POST_FLAG_BCH;
+    } else {
+        DEBUG_LOG_FLUSH("WARNING: BCH encoder test failed\r\n");
+    }
+    
+    // Test fixed-point position encoders
+    if(test_position_encoding_2g()) {
+        flags |= POST_FLAG_POSITION;
+    } else {
+        DEBUG_LOG_FLUSH("WARNING: Position encoder test failed\r\n");
+    }
+    
+    // Verify chip clock schedule (accumulated error over one burst)
+    if(verify_chip_clock_schedule()) {
+        flags |= POST_FLAG_CHIP_CLOCK;
+    } else {
+        DEBUG_LOG_FLUSH("WARNING: Chip clock schedule drift\r\n");
+    }
+    
+    // Phase 3 interval dither generator (known values)
+    if(test_elt_interval_rng_2g()) {
+        flags |= POST_FLAG_ELT_RNG;
+    } else {
+        DEBUG_LOG_FLUSH("WARNING: ELT interval dither generator mismatch\r\n");
+    }
+    
+    return flags;
+}
 
-    return (!is_transmission_active_2g()) && 
-           ((current_millis - last_tx) >= get_current_interval_2g());
+static void store_post_results(uint16_t flags) {
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    uint32_t hash = firmware_build_id();
+    rf_calibration_t* cal = rf_get_calibration();
+    
+    memset(payload, 0xFF, sizeof(payload));
+    payload[POST_REC_HASH_LO] = (uint16_t)hash;
+    payload[POST_REC_HASH_HI] = (uint16_t)(hash >> 16);
+    payload[POST_REC_FLAGS] = flags;
+    payload[POST_REC_I_OFFSET] = cal->i_offset;
+    payload[POST_REC_Q_OFFSET] = cal->q_offset;
+    memcpy(&payload[POST_REC_I_GAIN], &cal->i_gain, sizeof(float));
+    memcpy(&payload[POST_REC_Q_GAIN], &cal->q_gain, sizeof(float));
+    
+    cfg_store_write(CFG_TYPE_POST, payload);
+}
+
+// Restore the calibration if this firmware already passed every self-test
+static uint8_t restore_post_results(void) {
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    uint32_t hash = firmware_build_id();
+    
+    if(!cfg_store_read(CFG_TYPE_POST, payload) ||
+       payload[POST_REC_HASH_LO] != (uint16_t)hash ||
+       payload[POST_REC_HASH_HI] != (uint16_t)(hash >> 16) ||
+       payload[POST_REC_FLAGS] != POST_ALL_PASSED) {
+        return 0;
+    }
+    
+    rf_calibration_t cal;
+    cal.i_offset = payload[POST_REC_I_OFFSET];
+    cal.q_offset = payload[POST_REC_Q_OFFSET];
+    memcpy(&cal.i_gain, &payload[POST_REC_I_GAIN], sizeof(float));
+    memcpy(&cal.q_gain, &payload[POST_REC_Q_GAIN], sizeof(float));
+    rf_calibration_load(&cal);
+    return 1;
+}
+
+// =============================================================================
+// SCHEDULER JOBS
+// =============================================================================
+
+static void gps_job(void) {
+    gps_update();
+}
+
+// Report the CPU active fraction of the cycle that ends now
+static void report_duty_cycle(void) {
+    uint32_t now_us = get_system_time_us();
+    uint32_t idle_us = get_power_stats()->idle_us;
+    uint32_t elapsed_ms = (now_us - cycle_start_us) / 1000;
+    uint32_t idle_ms = (idle_us - cycle_idle_start_us) / 1000;
+    
+    if(cycle_start_us != 0 && elapsed_ms != 0) {
+        uint16_t active_permille = (uint16_t)(((elapsed_ms - idle_ms) * 1000) / elapsed_ms);
+        DEBUG_EVENT3(MSG_POWER_DUTY, cycle_phase, active_permille, elapsed_ms);
+    }
+    
+    cycle_start_us = now_us;
+    cycle_idle_start_us = idle_us;
+    cycle_phase = (frame_type == BEACON_TEST_FRAME_2G) ? 0 : elt_state_2g.current_phase + 1;
+}
+
+// Single owner of transmit decisions
+static void tx_job(void) {
+    rf_bringup_start();
+    report_duty_cycle();
+    start_beacon_frame_2g(frame_type);
+    rf_report_bringup_stats();
+    spi_report_sched_stats();
+    gps_report_rx_stats();
+    
+    if(!boot_timing_reported) {
+        DEBUG_EVENT4(MSG_BOOT_TIMING, ready_time_us, ready_time_us >> 16,
+                     chip_timer_first_start_us, chip_timer_first_start_us >> 16);
+        boot_timing_reported = 1;
+    }
+    
+    uint32_t now = get_system_time_us();
+    if(TEST_CONTINUOUS_MODE && frame_type == BEACON_TEST_FRAME_2G) {
+        // Back to back: the minimum gap runs from the end of this burst
+        tx_deadline_us = now + TEST_CONTINUOUS_GAP_MS * 1000UL;
+    } else {
+        // Start-to-start spacing from the deadline, not from the end of the burst
+        tx_deadline_us += next_tx_interval_us();
+        if((int32_t)(tx_deadline_us - now) < 0) {
+            tx_deadline_us = now;
+        }
+    }
+    sched_set_deadline(SCHED_JOB_TX, tx_deadline_us);
+    
+    sched_print_stats();
+    debug_report_tx_stats();
+    stack_report();
+}
+
+static void status_led_job(void) {
+    toggle_status_led();
+}
+
+static void rf_status_job(void) {
+    rf_update_status();
+}
+
+// Self-tests skipped at boot (cached pass), re-run once after the first burst.
+// A failure rewrites the cached flags so the next boot runs them up front
+static void selftest_job(void) {
+    uint16_t flags = run_self_tests();
+    DEBUG_EVENT2(MSG_POST_RESULT, 2, flags);
+    if(flags != POST_ALL_PASSED) {
+        store_post_results(flags);
+    }
 }
 
 int main(void) {
     __builtin_disable_interrupts();
+    stack_paint();
     
     // Initialize system
     system_init();
@@ -62,62 +251,62 @@ int main(void) {
     gps_init();
     oqpsk_init();
     
-    // Verify PRN sequences
-    if(!verify_prn_sequence(PRN_MODE_NORMAL)) {
-        DEBUG_LOG_FLUSH("WARNING: PRN sequence verification failed\r\n");
-    }
+    // Load beacon configuration (opens the configuration store)
+    load_beacon_configuration_2g();
     
-    // Test BCH encoder
-    if(!test_bch_encoder_2g()) {
-        DEBUG_LOG_FLUSH("WARNING: BCH encoder test failed\r\n");
+    // Self-tests and calibration: reuse the cached pass of this firmware and
+    // defer the tests until after the first burst, else run them now
+    uint8_t post_deferred = restore_post_results();
+    if(post_deferred) {
+        DEBUG_LOG_FLUSH("Self-tests cached - deferred until after first burst\r\n");
+        DEBUG_EVENT2(MSG_POST_RESULT, 1, POST_ALL_PASSED);
+    } else {
+        rf_calibration_init();
+        uint16_t flags = run_self_tests();
+        DEBUG_EVENT2(MSG_POST_RESULT, 0, flags);
+        if(flags == POST_ALL_PASSED) {
+            store_post_results(flags);
+        }
     }
     
-    // Load beacon configuration
-    load_beacon_configuration_2g();
-    
     // Determine frame type from switch
-    beacon_frame_type_2g_t frame_type = get_frame_type_from_switch();
+    frame_type = get_frame_type_from_switch();
     DEBUG_LOG_FLUSH("Starting transmission - Mode: ");
     
     if(frame_type == BEACON_TEST_FRAME_2G) {
-        DEBUG_LOG_FLUSH("TEST (decoder validation)\r\n");
+        DEBUG_LOG_FLUSH(TEST_CONTINUOUS_MODE ? "TEST continuous (decoder stress)\r\n" :
+                                               "TEST (decoder validation)\r\n");
         tx_interval_ms = TEST_INTERVAL;
         beacon_config_2g.test_mode = 1;
+        rf_sched_configure_2g(rf_cycle_test, sizeof(rf_cycle_test) / sizeof(rf_cycle_test[0]));
     } else {
         DEBUG_LOG_FLUSH("EXERCISE (ELT simulation)\r\n");
         beacon_config_2g.test_mode = 0;
+        rf_sched_configure_2g(rf_cycle_exercise, sizeof(rf_cycle_exercise) / sizeof(rf_cycle_exercise[0]));
         start_elt_sequence_2g();
     }
     
     DEBUG_LOG_FLUSH("Beacon ready - entering main loop\r\n");
+    DEBUG_EVENT1(MSG_BOOT, frame_type == BEACON_EXERCISE_FRAME_2G);
+    frame_arena_report();
     
-    // Main loop
-    while(1) {
-        uint32_t current_time = millis_counter;
-        
-        // Update GPS data
-        gps_update();
-        
-        // Check if transmission should occur
-        if(should_transmit_beacon()) {
-            start_beacon_frame_2g(frame_type);
-        }
-        
-        // Run beacon task
-        beacon_task_2g();
-        
-        // Update RF status
-        rf_update_status();
-        
-        // Status indication
-        if((current_time % 1000) == 0) {  // Every second
-            toggle_status_led();
-        }
-        
-        // Small delay to prevent watchdog timeout
-        system_delay_ms(100);
+    // Timed jobs - first burst straight away
+    uint32_t now = get_system_time_us();
+    ready_time_us = now;
+    tx_deadline_us = now;
+    
+    sched_add_job(SCHED_JOB_GPS, gps_job, now, GPS_SERVICE_PERIOD_US);
+    sched_add_job(SCHED_JOB_TX, tx_job, tx_deadline_us, 0);
+    sched_add_job(SCHED_JOB_LED, status_led_job, now + STATUS_LED_PERIOD_US, STATUS_LED_PERIOD_US);
+    sched_add_job(SCHED_JOB_RF_STATUS, rf_status_job, now, RF_STATUS_PERIOD_US);
+    if(post_deferred) {
+        // Same deadline as the first burst: the lower TX job ID runs first
+        sched_add_job(SCHED_JOB_SELFTEST, selftest_job, tx_deadline_us, 0);
     }
     
+    // Main loop
+    sched_run();
+    
     return 0;
 }
 
@@ -125,37 +314,28 @@ void start_beacon_frame_2g(beacon_frame_type_2g_t frame_type) {
     DEBUG_LOG_FLUSH("\r\n=== STARTING BEACON TRANSMISSION ===\r\n");
     
     // Update system time for rotating fields
-    system_time_2g = millis_counter;
+    system_time_2g = get_system_time_ms();
     
     // Set beacon configuration based on frame type
+    // Rotating field type comes from the scheduler cycle (RF_CYCLE_*)
     if(frame_type == BEACON_TEST_FRAME_2G) {
         beacon_config_2g.test_mode = 1;
-        beacon_config_2g.rotating_type = RF_TYPE_G008_2G;
         DEBUG_LOG_FLUSH("Mode: TEST - Fixed position (Grenoble)\r\n");
     } else {
         beacon_config_2g.test_mode = 0;
-        beacon_config_2g.rotating_type = RF_TYPE_ELTDT_2G;
-        DEBUG_LOG_FLUSH("Mode: EXERCISE - ELT Phase ");
-        debug_print_dec(elt_state_2g.current_phase + 1);
-        DEBUG_LOG_FLUSH("\r\n");
+        DEBUG_LOG_FLUSH("Mode: EXERCISE\r\n");
     }
+    DEBUG_EVENT2(MSG_TX_START, !beacon_config_2g.test_mode, elt_state_2g.current_phase + 1);
     
     // Build and transmit frame
     transmit_beacon_2g();
     
-    // Update transmission time
-    last_tx_time = millis_counter;
-    
     // For exercise mode, update ELT state
     if(frame_type == BEACON_EXERCISE_FRAME_2G) {
         elt_state_2g.transmission_count++;
         check_phase_transition_2g();
         
-        DEBUG_LOG_FLUSH("ELT transmission #");
-        debug_print_dec(elt_state_2g.transmission_count);
-        DEBUG_LOG_FLUSH(" in phase ");
-        debug_print_dec(elt_state_2g.current_phase + 1);
-        DEBUG_LOG_FLUSH("\r\n");
+        DEBUG_EVENT2(MSG_ELT_TX, elt_state_2g.transmission_count, elt_state_2g.current_phase + 1);
     }
     
     DEBUG_LOG_FLUSH("=== TRANSMISSION COMPLETE ===\r\n");
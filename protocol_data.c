@@ -13,9 +13,14 @@
 // GLOBAL VARIABLES
 // =============================================================================
 
-// Frame buffers
-uint8_t beacon_frame_2g[252] = {0};
-uint8_t frame_2g_info[202] = {0};
+// Frame buffers (see FRAME ARENA in protocol_data.h)
+frame_arena_t frame_arena;
+
+FRAME_ARENA_STATIC_ASSERT(sizeof(frame_arena_t) <= FRAME_ARENA_BUDGET_BYTES, budget);
+
+#define FRAME_ARENA_PHASE_ASSERT(name, bytes, budget) \
+    FRAME_ARENA_STATIC_ASSERT((bytes) <= (budget), phase_##name);
+FRAME_ARENA_PHASES(FRAME_ARENA_PHASE_ASSERT)
 
 // Beacon configuration
 beacon_config_2g_t beacon_config_2g = {
@@ -37,230 +42,541 @@ elt_state_2g_t elt_state_2g = {
     .active = 0
 };
 
+// GPS fix cache (filled on first use)
+gps_fix_cache_2g_t gps_fix_cache_2g = {0};
+
+// Rotating field scheduler (blocks encoded on first use)
+rf_scheduler_2g_t rf_sched_2g = {
+    .cycle = { RF_TYPE_G008_2G },
+    .length = 1
+};
+
 // System state
 uint32_t system_time_2g = 0;
+uint32_t frame_sequence_2g = 0;         // Continuous TEST mode frame counter
 uint32_t last_update_2g = 0;
-float current_latitude_2g = 45.1885;   // Grenoble (test position)
-float current_longitude_2g = 5.7245;
-float current_altitude_2g = 214.0;
+int32_t current_latitude_e7_2g = 451885000;   // Grenoble (test position)
+int32_t current_longitude_e7_2g = 57245000;
+int32_t current_altitude_cm_2g = 21400;
 
 // =============================================================================
-// FRAME BUILDING FUNCTIONS
+// FRAME FIELD LAYOUT
 // =============================================================================
 
-void build_2g_information_field(uint8_t* info_bits) {
-    memset(info_bits, 0, 202);
-    
-    DEBUG_LOG_FLUSH("Building 2G information field...\r\n");
-    
-    // Bit allocation per T.018 Appendix E
-    // Bits 1-43: TAC + Serial Number + Country Code (23 HEX ID)
-    set_23_hex_id_2g(info_bits);
-    
-    // Bits 44-90: Encoded Location (47 bits)
-    gps_data_t* gps = get_current_gps_data();
-    if(gps && gps->valid) {
-        encode_location_2g(info_bits, gps->latitude, gps->longitude);
-    } else {
-        // Use fixed test position
-        encode_location_2g(info_bits, current_latitude_2g, current_longitude_2g);
+// T.018 Appendix E bit allocation (bit numbers 1-based in the comments)
+static const frame_field_desc_t frame_main_fields[FIELD_MAIN_COUNT] = {
+    {   0, 16, FIELD_TAC         },     // 1-16    TAC
+    {  16, 14, FIELD_SERIAL      },     // 17-30   Serial number
+    {  30, 10, FIELD_COUNTRY     },     // 31-40   Country code
+    {  40,  3, FIELD_PROTOCOL    },     // 41-43   Protocol
+    {  43, 23, FIELD_LATITUDE    },     // 44-66   Encoded latitude
+    {  66, 24, FIELD_LONGITUDE   },     // 67-90   Encoded longitude
+    {  90, 47, FIELD_VESSEL_ID   },     // 91-137  Vessel ID
+    { 137,  3, FIELD_BEACON_TYPE },     // 138-140 Beacon type
+    { 140, 14, FIELD_SPARE       },     // 141-154 Spare (all 1s for cancel)
+    { 154,  4, FIELD_RF_TYPE     },     // 155-158 Rotating field type
+};
+
+// G008 and ELT-DT share the time/altitude layout in this firmware
+static const frame_field_desc_t frame_rf_time_alt_fields[] = {
+    { 158, 16, FIELD_RF_TIME     },     // 159-174 Time value
+    { 174, 10, FIELD_RF_ALTITUDE },     // 175-184 Altitude code
+    { 184, 18, FIELD_RF_SEQUENCE },     // 185-202 Spare (continuous TEST sequence)
+};
+
+static const frame_field_desc_t frame_rf_rls_fields[] = {
+    { 158,  8, FIELD_RLS_PROVIDER },    // 159-166 RLS provider
+    { 166, 36, FIELD_RLS_DATA     },    // 167-202 RLS data
+};
+
+static const frame_field_desc_t frame_rf_cancel_fields[] = {
+    { 158,  2, FIELD_CANCEL_METHOD },   // 159-160 Deactivation method
+    { 160, 42, FIELD_CANCEL_FIXED  },   // 161-202 Fixed, all 1s
+};
+
+#define FRAME_LAYOUT(table)     { table, sizeof(table) / sizeof(table[0]) }
+
+const frame_layout_t frame_main_layout = FRAME_LAYOUT(frame_main_fields);
+
+static const frame_layout_t frame_rotating_layouts[] = {
+    FRAME_LAYOUT(frame_rf_time_alt_fields),     // RF_TYPE_G008_2G
+    FRAME_LAYOUT(frame_rf_time_alt_fields),     // RF_TYPE_ELTDT_2G
+    FRAME_LAYOUT(frame_rf_rls_fields),          // RF_TYPE_RLS_2G
+    FRAME_LAYOUT(frame_rf_cancel_fields),       // RF_TYPE_CANCEL_2G
+};
+
+const frame_layout_t* frame_rotating_layout(rotating_field_type_2g_t rf_type) {
+    if(rf_type > RF_TYPE_CANCEL_2G) {
+        rf_type = RF_TYPE_G008_2G;
     }
+    return &frame_rotating_layouts[rf_type];
+}
+
+// Streaming MSB-first writer: field bits go through a 32-bit accumulator in
+// chunks of up to 16 and leave as whole bytes, so adjacent fields share byte
+// writes. Bits before the first field and after the last one are preserved.
+// The fields must be sorted and contiguous
+void frame_pack_fields(uint8_t* info_bits, const frame_field_desc_t* fields, uint8_t count,
+                       const uint64_t* values) {
+    uint16_t start = fields[0].start;
+    uint8_t* out = &info_bits[start >> 3];
+    uint8_t pending = start & 7;            // Bits in acc not yet written
+    uint32_t acc = *out >> (8 - pending);
     
-    // Bits 91-137: Vessel ID (47 bits)
-    set_vessel_id_2g(info_bits);
-    
-    // Bits 138-140: Beacon Type (3 bits)
-    set_bit_field(info_bits, 137, 3, beacon_config_2g.protocol_code);
-    
-    // Bits 141-154: Spare bits (14 bits)
-    if(beacon_config_2g.rotating_type == RF_TYPE_CANCEL_2G) {
-        set_bit_field(info_bits, 140, 14, 0x3FFF);  // All 1s for cancel
-    } else {
-        set_bit_field(info_bits, 140, 14, 0);       // All 0s otherwise
+    for(uint8_t f = 0; f < count; f++) {
+        uint64_t value = values[fields[f].source];
+        uint8_t remaining = fields[f].width;
+        
+        while(remaining) {
+            uint8_t take = (remaining > 16) ? 16 : remaining;
+            remaining -= take;
+            acc = (acc << take) | ((uint32_t)(value >> remaining) & ((1UL << take) - 1));
+            pending += take;
+            while(pending >= 8) {
+                pending -= 8;
+                *out++ = (uint8_t)(acc >> pending);
+            }
+        }
     }
     
-    // Bits 155-202: Rotating Field (48 bits)
-    set_rotating_field_2g(info_bits, beacon_config_2g.rotating_type);
+    if(pending) {
+        *out = (uint8_t)(acc << (8 - pending)) | (*out & (0xFF >> pending));
+    }
+}
+
+// Reverse of frame_pack_fields: one pass, one byte read per 8 bits
+void frame_unpack_fields(const uint8_t* info_bits, const frame_field_desc_t* fields, uint8_t count,
+                         uint64_t* values) {
+    uint16_t start = fields[0].start;
+    const uint8_t* in = &info_bits[start >> 3];
+    uint8_t available = 8 - (start & 7);    // Unread bits in acc
+    uint32_t acc = *in++ & (0xFF >> (start & 7));
     
-    DEBUG_LOG_FLUSH("2G information field built\r\n");
+    for(uint8_t f = 0; f < count; f++) {
+        uint64_t value = 0;
+        uint8_t remaining = fields[f].width;
+        
+        while(remaining) {
+            uint8_t take = (remaining > 16) ? 16 : remaining;
+            remaining -= take;
+            while(available < take) {
+                acc = (acc << 8) | *in++;
+                available += 8;
+            }
+            available -= take;
+            value = (value << take) | ((acc >> available) & ((1UL << take) - 1));
+        }
+        values[fields[f].source] = value;
+    }
+}
+
+// Configuration fields the 23 HEX ID is built from. TAC must be > 10000
+// for real beacons
+static void frame_gather_id_fields(uint64_t* values) {
+    values[FIELD_TAC] = (beacon_config_2g.test_mode) ? 9999 : 10001;
+    values[FIELD_SERIAL] = beacon_config_2g.beacon_id & 0x3FFF;
+    values[FIELD_COUNTRY] = beacon_config_2g.country_code & 0x3FF;
+    values[FIELD_PROTOCOL] = beacon_config_2g.protocol_code & 0x7;
+    values[FIELD_VESSEL_ID] = get_configured_vessel_id_2g();
+    values[FIELD_BEACON_TYPE] = beacon_config_2g.protocol_code & 0x7;
 }
 
-void build_2g_complete_frame(uint8_t* info_bits, uint8_t* complete_frame) {
-    memset(complete_frame, 0, 252);
+// Fields before the spare (bits 1-140): ID, then the location from the fix
+// cache (fixed test position without a valid fix)
+static void frame_gather_main_fields(uint64_t* values) {
+    frame_gather_id_fields(values);
     
-    // PRN header (2 bits)
-    complete_frame[0] = (beacon_config_2g.test_mode) ? 1 : 0;
-    complete_frame[1] = 0;  // Padding bit
+    gps_fix_cache_update_2g();
+    values[FIELD_LATITUDE] = gps_fix_cache_2g.lat_code;
+    values[FIELD_LONGITUDE] = gps_fix_cache_2g.lon_code;
+}
+
+// Spare, type and payload of one rotating field type (bits 141-202)
+static void frame_gather_rotating_fields(uint64_t* values, rotating_field_type_2g_t rf_type) {
+    rotating_field_data_2g_t rf_data = {0};
     
-    // Copy information bits (202 bits)
-    memcpy(&complete_frame[2], info_bits, 202);
+    values[FIELD_SPARE] = (rf_type == RF_TYPE_CANCEL_2G) ? 0x3FFF : 0;
+    values[FIELD_RF_TYPE] = rf_type;
     
-    // Calculate and append BCH parity (48 bits)
-    uint64_t bch_parity = compute_bch_250_202(info_bits);
-    for(int i = 0; i < 48; i++) {
-        complete_frame[204 + i] = (bch_parity >> (47 - i)) & 1;
+    fetch_rotating_field_data_2g(&rf_data, rf_type);
+    switch(rf_data.field_type) {
+        case RF_TYPE_G008_2G:
+        case RF_TYPE_ELTDT_2G:
+            values[FIELD_RF_TIME] = rf_data.time_value;
+            values[FIELD_RF_ALTITUDE] = rf_data.altitude_code;
+            values[FIELD_RF_SEQUENCE] = rf_data.sequence;
+            break;
+            
+        case RF_TYPE_RLS_2G:
+            values[FIELD_RLS_PROVIDER] = rf_data.rls_provider;
+            values[FIELD_RLS_DATA] = rf_data.rls_data;
+            break;
+            
+        case RF_TYPE_CANCEL_2G:
+            values[FIELD_CANCEL_METHOD] = rf_data.deactivation_method;
+            values[FIELD_CANCEL_FIXED] = 0x3FFFFFFFFFFULL;
+            break;
     }
 }
 
+// Current value of every field source
+void frame_gather_fields_2g(uint64_t* values) {
+    memset(values, 0, FIELD_NUM_SOURCES * sizeof(uint64_t));
+    frame_gather_main_fields(values);
+    frame_gather_rotating_fields(values, beacon_config_2g.rotating_type);
+}
+
+// =============================================================================
+// FRAME BUILDING FUNCTIONS
+// =============================================================================
+
 void build_compliant_frame_2g(void) {
-    // Build information field
-    build_2g_information_field(frame_2g_info);
+    // Rotating field of this burst from the scheduler cycle
+    beacon_config_2g.rotating_type = rf_sched_next_2g();
     
-    // Build complete frame with BCH
-    build_2g_complete_frame(frame_2g_info, beacon_frame_2g);
+    // Information field and BCH parity in one packed codeword: main fields
+    // packed fresh, rotating block and parity parts from the scheduler tables
+    rf_sched_build_codeword_2g(frame_2g_info, beacon_config_2g.rotating_type);
     
-    // Generate 23 HEX ID for logging
-    char hex_id[24];
-    generate_23hex_id_2g(frame_2g_info, hex_id);
-    DEBUG_LOG_FLUSH("Frame built - 23 HEX ID: ");
-    DEBUG_LOG_FLUSH(hex_id);
+    // 23 HEX ID for logging (cached, follows the configuration)
+    DEBUG_LOG_FLUSH("Frame built (");
+    DEBUG_LOG_FLUSH(get_rotating_field_name_2g(beacon_config_2g.rotating_type));
+    DEBUG_LOG_FLUSH(") - 23 HEX ID: ");
+    DEBUG_LOG_FLUSH(beacon_hex_id_2g());
     DEBUG_LOG_FLUSH("\r\n");
 }
 
 // =============================================================================
-// FRAME COMPONENT FUNCTIONS
+// GPS POSITION ENCODING
 // =============================================================================
 
-void set_23_hex_id_2g(uint8_t* info_bits) {
-    // Format: TAC (16 bits) + Serial (14 bits) + Country (10 bits) + Protocol (3 bits)
-    uint64_t hex_id = 0;
+// T.018 Appendix C: latitude 23 bits over 180 deg, longitude 24 bits over
+// 360 deg. Both steps are 3515625/2^14 units of 1e-7 degree, so a code is
+// floor(u * 2^14 / 3515625) with u the offset input. No FPU on the dsPIC:
+// multiply by floor(2^53 / 3515625) and shift, which gives the exact code
+// or one less for any 32-bit u, then one multiply-compare corrects it
+#define POS_CODE_DIVISOR    3515625UL
+#define POS_CODE_RECIP      2562047788UL    // floor(2^53 / 3515625)
+
+// Altitude: 10 bits over -1500..+17000 m, code = floor(v * 1023 / 1850000)
+// with v in cm above -1500 m. ceil(2^52 / 1850000) is exact for v * 1023 < 2^31
+#define ALT_CODE_RECIP      2434378177ULL   // ceil(2^52 / 1850000)
+
+static uint32_t position_scale_code(uint32_t u) {
+    uint32_t q = (uint32_t)(((uint64_t)u * POS_CODE_RECIP) >> 39);
+    if((uint64_t)(q + 1) * POS_CODE_DIVISOR <= ((uint64_t)u << 14)) {
+        q++;
+    }
+    return q;
+}
+
+uint32_t latitude_to_code_2g(int32_t lat_e7) {
+    if(lat_e7 < -900000000L) return 0;
+    if(lat_e7 >= 900000000L) return 0x7FFFFF;     // +90 saturates (23 bits)
+    return position_scale_code((uint32_t)(lat_e7 + 900000000L));
+}
+
+uint32_t longitude_to_code_2g(int32_t lon_e7) {
+    if(lon_e7 < -1800000000L) return 0;
+    if(lon_e7 >= 1800000000L) return 0xFFFFFF;    // +180 saturates (24 bits)
+    return position_scale_code((uint32_t)lon_e7 + 1800000000UL);
+}
+
+uint64_t encode_gps_position_2g(int32_t lat_e7, int32_t lon_e7) {
+    return ((uint64_t)latitude_to_code_2g(lat_e7) << 24) | longitude_to_code_2g(lon_e7);
+}
+
+void encode_location_appendix_c(uint8_t* info_bits, int32_t lat_e7, int32_t lon_e7) {
+    uint64_t encoded_pos = encode_gps_position_2g(lat_e7, lon_e7);
+    set_bit_field(info_bits, 43, 47, encoded_pos);
+}
+
+// Known vectors (Grenoble test position, range ends) and encoder cost
+uint8_t test_position_encoding_2g(void) {
+    DEBUG_LOG_FLUSH("Testing position encoders...\r\n");
+    
+    uint16_t t_start = SYSTEM_TIME_US16();
+    uint32_t lat_code = latitude_to_code_2g(451885000L);
+    uint32_t lon_code = longitude_to_code_2g(57245000L);
+    uint16_t alt_code = altitude_to_code_2g(21400L);
+    uint16_t elapsed_us = SYSTEM_TIME_US16() - t_start;
     
-    // TAC must be > 10000 for real beacons
-    uint16_t tac = (beacon_config_2g.test_mode) ? 9999 : 10001;
+    uint8_t ok = (lat_code == 6300240UL) && (lon_code == 8655389UL) && (alt_code == 94) &&
+                 (latitude_to_code_2g(-900000000L) == 0) &&
+                 (latitude_to_code_2g(900000000L) == 0x7FFFFF) &&
+                 (longitude_to_code_2g(1799999999L) == 0xFFFFFF) &&
+                 (altitude_to_code_2g(1700000L) == 1023);
     
-    hex_id |= ((uint64_t)tac & 0xFFFF) << 27;
-    hex_id |= ((uint64_t)beacon_config_2g.beacon_id & 0x3FFF) << 13;
-    hex_id |= ((uint64_t)beacon_config_2g.country_code & 0x3FF) << 3;
-    hex_id |= (beacon_config_2g.protocol_code & 0x7);
+    // 100 FCY cycles per microsecond
+    DEBUG_LOG_FLUSH("Position encode (lat+lon+alt): ");
+    debug_print_dec((uint32_t)(elapsed_us + 1) * 100);
+    DEBUG_LOG_FLUSH(" cycles max\r\n");
+    DEBUG_LOG_FLUSH(ok ? "Position encoder test PASSED\r\n" : "Position encoder test FAILED\r\n");
     
-    set_bit_field(info_bits, 0, 43, hex_id);
+    return ok;
+}
+
+// =============================================================================
+// GPS FIX CACHE
+// =============================================================================
+
+// First input (offset units) whose code is >= code: ceil(code * span / 2^bits)
+static int32_t code_cell_start(uint32_t code, uint32_t span, uint8_t bits, int32_t offset) {
+    uint64_t scaled = (uint64_t)code * span;
+    return (int32_t)((scaled + ((1ULL << bits) - 1)) >> bits) - offset;
+}
+
+// Altitude code cell: code a covers [ceil(a * 1850000 / 1023) - 150000, ...)
+// The two end codes also cover everything clamped into them
+static int32_t altitude_cell_start(uint16_t code) {
+    if(code == 0) return INT32_MIN;
+    if(code > 1023) return INT32_MAX;
+    return (int32_t)(((uint32_t)code * 1850000UL + 1022) / 1023) - 150000;
 }
 
-void encode_location_2g(uint8_t* info_bits, float latitude, float longitude) {
-    // Convert to binary encoding per T.018 Appendix C
-    // Latitude: 23 bits (-90 to +90 degrees)
-    // Longitude: 24 bits (-180 to +180 degrees)
+// Re-encode the location/altitude/time fields only when the current fix
+// leaves the cached cells. Returns 1 if the cache was refreshed
+uint8_t gps_fix_cache_update_2g(void) {
+    gps_fix_cache_2g_t* cache = &gps_fix_cache_2g;
+    gps_data_t* gps = get_current_gps_data();
+    uint8_t gps_valid = (gps && gps->valid);
     
-    int32_t lat_encoded = (int32_t)((latitude + 90.0) * (1L << 23) / 180.0);
-    int32_t lon_encoded = (int32_t)((longitude + 180.0) * (1L << 24) / 360.0);
+    int32_t lat_e7, lon_e7, alt_cm;
+    uint8_t day = 0, hour = 0, minute = 0;
     
-    // Ensure within bounds
-    lat_encoded &= 0x7FFFFF;  // 23 bits
-    lon_encoded &= 0xFFFFFF;  // 24 bits
+    if(gps_valid) {
+        lat_e7 = gps->latitude_e7;
+        lon_e7 = gps->longitude_e7;
+        alt_cm = gps->altitude_cm;
+        day = gps->day;
+        hour = gps->hour;
+        minute = gps->minute;
+    } else {
+        // Fixed test position, no time
+        lat_e7 = current_latitude_e7_2g;
+        lon_e7 = current_longitude_e7_2g;
+        alt_cm = current_altitude_cm_2g;
+    }
+    
+    // Same source and every input still inside its cell: nothing to encode
+    if(cache->initialized && cache->gps_valid == gps_valid &&
+       lat_e7 >= cache->lat_lo_e7 && lat_e7 < cache->lat_hi_e7 &&
+       lon_e7 >= cache->lon_lo_e7 && lon_e7 < cache->lon_hi_e7 &&
+       alt_cm >= cache->alt_lo_cm && alt_cm < cache->alt_hi_cm &&
+       day == cache->day && hour == cache->hour && minute == cache->minute) {
+        return 0;
+    }
     
-    // Set in frame (bits 44-90)
-    set_bit_field(info_bits, 43, 23, lat_encoded);
-    set_bit_field(info_bits, 66, 24, lon_encoded);
+    cache->lat_code = latitude_to_code_2g(lat_e7);
+    cache->lon_code = longitude_to_code_2g(lon_e7);
+    uint16_t alt_code10 = altitude_to_code_2g(alt_cm);
+    cache->altitude_code = alt_code10;
+    cache->time_value = gps_valid ? encode_time_value_2g(day, hour, minute, RF_TYPE_G008_2G) : 0;
+    
+    // Input cells of the new codes (T.018 Appendix C resolution)
+    cache->lat_lo_e7 = code_cell_start(cache->lat_code, 1800000000UL, 23, 900000000L);
+    cache->lat_hi_e7 = code_cell_start(cache->lat_code + 1, 1800000000UL, 23, 900000000L);
+    cache->lon_lo_e7 = code_cell_start(cache->lon_code, 3600000000UL, 24, 1800000000L);
+    cache->lon_hi_e7 = code_cell_start(cache->lon_code + 1, 3600000000UL, 24, 1800000000L);
+    cache->alt_lo_cm = altitude_cell_start(alt_code10);
+    cache->alt_hi_cm = altitude_cell_start(alt_code10 + 1);
+    
+    cache->day = day;
+    cache->hour = hour;
+    cache->minute = minute;
+    cache->gps_valid = gps_valid;
+    cache->initialized = 1;
+    cache->refresh_count++;
+    
+    return 1;
 }
 
-void set_vessel_id_2g(uint8_t* info_bits) {
-    uint64_t vessel_id = get_configured_vessel_id_2g();
-    set_bit_field(info_bits, 90, 47, vessel_id);
+void gps_fix_cache_invalidate_2g(void) {
+    gps_fix_cache_2g.initialized = 0;
 }
 
-void set_rotating_field_2g(uint8_t* info_bits, rotating_field_type_2g_t rf_type) {
-    rotating_field_data_2g_t rf_data = {0};
-    prepare_rotating_field_data_2g(&rf_data);
+// =============================================================================
+// FRAME DECODER
+// =============================================================================
+
+// Centre of a position code cell, in 1e-7 degree
+static int32_t code_cell_centre(uint32_t code, uint32_t span, uint8_t bits, int32_t offset) {
+    int32_t lo = code_cell_start(code, span, bits, offset);
+    int32_t hi = code_cell_start(code + 1, span, bits, offset);
+    return lo + (hi - lo) / 2;
+}
+
+// Centre of an altitude code cell in cm; the end codes use the range ends
+static int32_t altitude_cell_centre(uint16_t code) {
+    int32_t lo = (code == 0) ? -150000L : altitude_cell_start(code);
+    int32_t hi = (code >= 1023) ? 1700000L : altitude_cell_start(code + 1);
+    return lo + (hi - lo) / 2;
+}
+
+// Returns frame->well_formed. Unknown rotating field types leave the
+// rotating payload zeroed
+uint8_t frame_decode_2g(const uint8_t* info_bits, frame_decoded_2g_t* frame) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    
+    memset(values, 0, sizeof(values));
+    frame_unpack_fields(info_bits, frame_main_layout.fields, frame_main_layout.count, values);
+    
+    uint8_t rf_type = (uint8_t)values[FIELD_RF_TYPE];
+    uint8_t known = (rf_type <= RF_TYPE_CANCEL_2G);
+    if(known) {
+        const frame_layout_t* rotating = frame_rotating_layout((rotating_field_type_2g_t)rf_type);
+        frame_unpack_fields(info_bits, rotating->fields, rotating->count, values);
+    }
     
-    // Set rotating field type identifier (4 bits)
-    set_bit_field(info_bits, 154, 4, rf_type);
+    frame->tac = (uint16_t)values[FIELD_TAC];
+    frame->serial = (uint16_t)values[FIELD_SERIAL];
+    frame->country = (uint16_t)values[FIELD_COUNTRY];
+    frame->protocol = (uint8_t)values[FIELD_PROTOCOL];
+    frame->beacon_type = (uint8_t)values[FIELD_BEACON_TYPE];
+    frame->spare = (uint16_t)values[FIELD_SPARE];
+    frame->lat_code = (uint32_t)values[FIELD_LATITUDE];
+    frame->lon_code = (uint32_t)values[FIELD_LONGITUDE];
+    frame->latitude_e7 = code_cell_centre(frame->lat_code, 1800000000UL, 23, 900000000L);
+    frame->longitude_e7 = code_cell_centre(frame->lon_code, 3600000000UL, 24, 1800000000L);
+    frame->vessel_id = values[FIELD_VESSEL_ID];
+    
+    memset(&frame->rotating, 0, sizeof(frame->rotating));
+    frame->rotating.field_type = (rotating_field_type_2g_t)rf_type;
+    frame->altitude_cm = 0;
+    frame->well_formed = known &&
+                         frame->spare == ((rf_type == RF_TYPE_CANCEL_2G) ? 0x3FFF : 0);
     
     switch(rf_type) {
         case RF_TYPE_G008_2G:
         case RF_TYPE_ELTDT_2G:
-            // Time/Altitude data (44 bits)
-            set_bit_field(info_bits, 158, 16, rf_data.time_value);
-            set_bit_field(info_bits, 174, 10, rf_data.altitude_code);
-            set_bit_field(info_bits, 184, 18, 0);  // Spare bits
+            frame->rotating.time_value = (uint32_t)values[FIELD_RF_TIME];
+            frame->rotating.altitude_code = (uint16_t)values[FIELD_RF_ALTITUDE];
+            frame->rotating.sequence = (uint32_t)values[FIELD_RF_SEQUENCE];
+            frame->altitude_cm = altitude_cell_centre(frame->rotating.altitude_code);
             break;
             
         case RF_TYPE_RLS_2G:
-            // RLS provider and data
-            set_bit_field(info_bits, 158, 8, rf_data.rls_provider);
-            set_bit_field(info_bits, 166, 36, rf_data.rls_data);
+            frame->rotating.rls_provider = (uint8_t)values[FIELD_RLS_PROVIDER];
+            frame->rotating.rls_data = values[FIELD_RLS_DATA];
             break;
             
         case RF_TYPE_CANCEL_2G:
-            // Cancellation method
-            set_bit_field(info_bits, 158, 2, rf_data.deactivation_method);
-            // Fixed bits - all 42 bits set to 1 (T.018 spec)
-            set_bit_field_64(info_bits, 160, 42, 0x3FFFFFFFFFFULL);
+            frame->rotating.deactivation_method = (uint8_t)values[FIELD_CANCEL_METHOD];
+            frame->well_formed &= (values[FIELD_CANCEL_FIXED] == 0x3FFFFFFFFFFULL);
             break;
     }
+    
+    format_23hex_id_2g(frame, frame->hex_id);
+    return frame->well_formed;
 }
 
 // =============================================================================
-// GPS POSITION ENCODING
+// FRAME ARENA REPORT
 // =============================================================================
 
-uint64_t encode_gps_position_2g(double lat, double lon) {
-    int32_t lat_encoded = (int32_t)((lat + 90.0) * (1L << 23) / 180.0);
-    int32_t lon_encoded = (int32_t)((lon + 180.0) * (1L << 24) / 360.0);
-    
-    lat_encoded &= 0x7FFFFF;  // 23 bits
-    lon_encoded &= 0xFFFFFF;  // 24 bits
-    
-    return ((uint64_t)lat_encoded << 24) | lon_encoded;
-}
-
-void encode_location_appendix_c(uint8_t* info_bits, float latitude, float longitude) {
-    uint64_t encoded_pos = encode_gps_position_2g(latitude, longitude);
-    set_bit_field(info_bits, 43, 47, encoded_pos);
+void frame_arena_report(void) {
+    DEBUG_EVENT4(MSG_FRAME_ARENA, sizeof(frame_arena_t), FRAME_ARENA_BUILD_BYTES,
+                 FRAME_ARENA_TX_BYTES, FRAME_ARENA_SELFTEST_BYTES);
 }
 
 // =============================================================================
 // 23 HEX ID GENERATION
 // =============================================================================
 
-void generate_23hex_id_2g(const uint8_t *frame_202bits, char *hex_id) {
-    uint8_t id_bits[92] = {0};
-    int pos = 0;
-
-    // Extract components according to T.018 Appendix B.2
-    id_bits[pos++] = 1;  // Fixed bit 1
+// 92-bit ID (T.018 Appendix B.2) as a 48-bit and a 44-bit word:
+// 1 | country (10) | 101 | TAC (16) | serial (14) | test protocol (1) |
+// beacon type (3) || vessel ID first 44 bits
+static void hex_id_format(uint16_t tac, uint16_t serial, uint16_t country, uint8_t protocol,
+                          uint8_t beacon_type, uint64_t vessel_id, char *hex_id) {
+    uint64_t hi = (1ULL << 47) |
+                  ((uint64_t)(country & 0x3FF) << 37) |
+                  (0x5ULL << 34) |
+                  ((uint64_t)tac << 18) |
+                  ((uint64_t)(serial & 0x3FFF) << 4) |
+                  ((uint64_t)(protocol & 0x1) << 3) |
+                  (beacon_type & 0x7);
+    uint64_t lo = (vessel_id >> 3) & 0xFFFFFFFFFFFULL;
     
-    // Country Code (bits 31-40)
-    for(int i = 30; i < 40; i++) {
-        id_bits[pos++] = frame_202bits[i];
+    for(int8_t i = 11; i >= 0; i--) {
+        hex_id[i] = "0123456789ABCDEF"[hi & 0xF];
+        hi >>= 4;
     }
-    
-    // Fixed bits
-    id_bits[pos++] = 1;  // Bit 12
-    id_bits[pos++] = 0;  // Bit 13
-    id_bits[pos++] = 1;  // Bit 14
-    
-    // TAC Number (bits 1-16)
-    for(int i = 0; i < 16; i++) {
-        id_bits[pos++] = frame_202bits[i];
-    }
-    
-    // Serial Number (bits 17-30)
-    for(int i = 16; i < 30; i++) {
-        id_bits[pos++] = frame_202bits[i];
+    for(int8_t i = 22; i >= 12; i--) {
+        hex_id[i] = "0123456789ABCDEF"[lo & 0xF];
+        lo >>= 4;
     }
-    
-    // Test Protocol (bit 43)
-    id_bits[pos++] = frame_202bits[42];
-    
-    // Beacon Type (bits 138-140)
-    for(int i = 137; i < 140; i++) {
-        id_bits[pos++] = frame_202bits[i];
+    hex_id[23] = '\0';
+}
+
+void format_23hex_id_2g(const frame_decoded_2g_t* frame, char* hex_id) {
+    hex_id_format(frame->tac, frame->serial, frame->country, frame->protocol,
+                  frame->beacon_type, frame->vessel_id, hex_id);
+}
+
+// Bytes [first, first + count) of the packed field as one big-endian word
+static uint64_t frame_load_word(const uint8_t *info_bits, uint8_t first, uint8_t count) {
+    uint64_t word = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        word = (word << 8) | info_bits[first + i];
     }
+    return word;
+}
+
+// Main field taken out of a word loaded by frame_load_word
+static uint64_t frame_word_field(uint64_t word, uint8_t first, uint8_t count, frame_field_source_t id) {
+    const frame_field_desc_t* f = &frame_main_fields[id];
+    return (word >> ((first + count) * 8 - f->start - f->width)) & ((1ULL << f->width) - 1);
+}
+
+// Two word loads cover every ID component: bytes 0-5 (bits 1-48: TAC,
+// serial, country, protocol) and bytes 11-17 (bits 89-144: vessel ID,
+// beacon type)
+void generate_23hex_id_2g(const uint8_t *frame_202bits, char *hex_id) {
+    uint64_t id_word = frame_load_word(frame_202bits, 0, 6);
+    uint64_t vessel_word = frame_load_word(frame_202bits, 11, 7);
     
-    // Vessel ID (first 44 bits)
-    for(int i = 90; i < 134; i++) {
-        id_bits[pos++] = frame_202bits[i];
-    }
+    hex_id_format((uint16_t)frame_word_field(id_word, 0, 6, FIELD_TAC),
+                  (uint16_t)frame_word_field(id_word, 0, 6, FIELD_SERIAL),
+                  (uint16_t)frame_word_field(id_word, 0, 6, FIELD_COUNTRY),
+                  (uint8_t)frame_word_field(id_word, 0, 6, FIELD_PROTOCOL),
+                  (uint8_t)frame_word_field(vessel_word, 11, 7, FIELD_BEACON_TYPE),
+                  frame_word_field(vessel_word, 11, 7, FIELD_VESSEL_ID), hex_id);
+}
 
-    // Convert to hexadecimal
-    for(int i = 0; i < 23; i++) {
-        uint8_t nibble = 0;
-        for(int j = 0; j < 4; j++) {
-            nibble = (nibble << 1) | id_bits[i*4 + j];
-        }
-        hex_id[i] = "0123456789ABCDEF"[nibble];
+// 23 HEX ID of the current configuration, formatted again only when one of
+// the configuration fields it is built from changes
+static struct {
+    uint8_t valid;
+    uint8_t test_mode;
+    uint8_t protocol_code;
+    uint16_t country_code;
+    uint32_t beacon_id;
+    uint64_t vessel_id;
+    char hex_id[24];
+} hex_id_cache_2g;
+
+const char* beacon_hex_id_2g(void) {
+    if(!hex_id_cache_2g.valid ||
+       hex_id_cache_2g.test_mode != beacon_config_2g.test_mode ||
+       hex_id_cache_2g.protocol_code != beacon_config_2g.protocol_code ||
+       hex_id_cache_2g.country_code != beacon_config_2g.country_code ||
+       hex_id_cache_2g.beacon_id != beacon_config_2g.beacon_id ||
+       hex_id_cache_2g.vessel_id != beacon_config_2g.vessel_id) {
+        uint64_t values[FIELD_NUM_SOURCES];
+        frame_gather_id_fields(values);
+        hex_id_format((uint16_t)values[FIELD_TAC], (uint16_t)values[FIELD_SERIAL],
+                      (uint16_t)values[FIELD_COUNTRY], (uint8_t)values[FIELD_PROTOCOL],
+                      (uint8_t)values[FIELD_BEACON_TYPE], values[FIELD_VESSEL_ID],
+                      hex_id_cache_2g.hex_id);
+        
+        hex_id_cache_2g.test_mode = beacon_config_2g.test_mode;
+        hex_id_cache_2g.protocol_code = beacon_config_2g.protocol_code;
+        hex_id_cache_2g.country_code = beacon_config_2g.country_code;
+        hex_id_cache_2g.beacon_id = beacon_config_2g.beacon_id;
+        hex_id_cache_2g.vessel_id = beacon_config_2g.vessel_id;
+        hex_id_cache_2g.valid = 1;
     }
-    hex_id[23] = '\0';
+    return hex_id_cache_2g.hex_id;
 }
 
 // =============================================================================
@@ -271,16 +587,17 @@ uint16_t get_last_location_time_2g(void) {
     return (uint16_t)((system_time_2g - last_update_2g) / 60);
 }
 
-uint16_t altitude_to_code_2g(double altitude) {
-    if(altitude < -1500) return 0;
-    if(altitude > 17000) return 1023;
+uint16_t altitude_to_code_2g(int32_t altitude_cm) {
+    if(altitude_cm <= -150000L) return 0;
+    if(altitude_cm >= 1700000L) return 1023;
     
-    int16_t encoded = (int16_t)((altitude + 1500) * 1023.0 / 18500.0);
-    return (uint16_t)(encoded & 0x3FF);
+    uint32_t scaled = (uint32_t)(altitude_cm + 150000L) * 1023UL;
+    return (uint16_t)(((uint64_t)scaled * ALT_CODE_RECIP) >> 52);
 }
 
-uint8_t encode_altitude_2g(float altitude_m) {
-    return (uint8_t)(altitude_to_code_2g(altitude_m) & 0xFF);
+// Full 10-bit code (the rotating field altitude is 10 bits wide)
+uint16_t encode_altitude_2g(int32_t altitude_cm) {
+    return altitude_to_code_2g(altitude_cm);
 }
 
 uint32_t encode_time_value_2g(uint8_t day, uint8_t hour, uint8_t minute, uint8_t type) {
@@ -293,14 +610,295 @@ uint32_t encode_time_value_2g(uint8_t day, uint8_t hour, uint8_t minute, uint8_t
     }
 }
 
+// =============================================================================
+// CONFIGURATION STORE
+// =============================================================================
+
+// Keep code and constants out of the store pages (2 x 1024 instruction words)
+static const __prog__ uint16_t cfg_store_area[2 * FLASH_PAGE_SIZE_ADDR / 2]
+    __attribute__((space(prog), address(CFG_STORE_PAGE0_ADDR), noload, used));
+
+static cfg_store_t cfg_store = {0};
+
+static uint32_t cfg_slot_addr(uint32_t page_addr, uint16_t slot) {
+    return page_addr + (uint32_t)slot * (2 * CFG_RECORD_WORDS);
+}
+
+// Read a slot; 1 if it holds an intact record (magic and CRC)
+static uint8_t cfg_read_slot(uint32_t page_addr, uint16_t slot, uint16_t* record) {
+    uint32_t addr = cfg_slot_addr(page_addr, slot);
+    for(uint8_t i = 0; i < CFG_RECORD_WORDS; i++) {
+        record[i] = flash_read_word(addr + 2 * i);
+    }
+    return ((record[0] & 0xFF00) == CFG_RECORD_MAGIC) &&
+           (crc16_ccitt_words(record, CFG_RECORD_WORDS - 1) == record[CFG_RECORD_WORDS - 1]);
+}
+
+static uint8_t cfg_write_slot(uint32_t page_addr, uint16_t slot, uint8_t type, const uint16_t* payload) {
+    uint16_t record[CFG_RECORD_WORDS];
+    record[0] = CFG_RECORD_MAGIC | type;
+    memcpy(&record[1], payload, CFG_RECORD_PAYLOAD_WORDS * sizeof(uint16_t));
+    record[CFG_RECORD_WORDS - 1] = crc16_ccitt_words(record, CFG_RECORD_WORDS - 1);
+    
+    if(!flash_write_words(cfg_slot_addr(page_addr, slot), record, CFG_RECORD_WORDS)) {
+        return 0;
+    }
+    
+    uint16_t check[CFG_RECORD_WORDS];
+    return cfg_read_slot(page_addr, slot, check) && (memcmp(check, record, sizeof(record)) == 0);
+}
+
+static uint8_t cfg_slot_erased(uint32_t page_addr, uint16_t slot) {
+    uint32_t addr = cfg_slot_addr(page_addr, slot);
+    for(uint8_t i = 0; i < CFG_RECORD_WORDS; i++) {
+        if(flash_read_word(addr + 2 * i) != FLASH_ERASED_WORD) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Page generation from its header slot, 0 if the page is not formatted
+static uint16_t cfg_page_generation(uint32_t page_addr) {
+    uint16_t record[CFG_RECORD_WORDS];
+    if(cfg_read_slot(page_addr, 0, record) && (record[0] & 0xFF) == CFG_TYPE_PAGE) {
+        return record[1];
+    }
+    return 0;
+}
+
+// Appended slots form a prefix, so the first erased slot is found by a
+// binary search on the header word: 6 reads for 64 slots, no page scan
+static uint16_t cfg_find_next_slot(uint32_t page_addr) {
+    uint16_t lo = 1;
+    uint16_t hi = CFG_SLOTS_PER_PAGE;
+    while(lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if(flash_read_word(cfg_slot_addr(page_addr, mid)) == FLASH_ERASED_WORD) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+static uint8_t cfg_format_page(uint32_t page_addr, uint16_t generation) {
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    memset(payload, 0xFF, sizeof(payload));
+    payload[0] = generation;
+    return flash_erase_page(page_addr) && cfg_write_slot(page_addr, 0, CFG_TYPE_PAGE, payload);
+}
+
+// Newest intact record of a type in a page, searching back from before_slot
+static uint8_t cfg_find_record(uint32_t page_addr, uint16_t before_slot, uint8_t type, uint16_t* record) {
+    for(uint16_t slot = before_slot; slot > 1; slot--) {
+        if(cfg_read_slot(page_addr, slot - 1, record) && (record[0] & 0xFF) == type) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Select the page with the newer generation (16-bit, wrap-aware)
+uint8_t cfg_store_init(void) {
+    uint16_t gen0 = cfg_page_generation(CFG_STORE_PAGE0_ADDR);
+    uint16_t gen1 = cfg_page_generation(CFG_STORE_PAGE1_ADDR);
+    
+    if(gen0 == 0 && gen1 == 0) {
+        // Blank or corrupt store: start a fresh log
+        cfg_store.ready = cfg_format_page(CFG_STORE_PAGE0_ADDR, 1);
+        cfg_store.page_addr = CFG_STORE_PAGE0_ADDR;
+        cfg_store.generation = 1;
+        cfg_store.next_slot = 1;
+        return cfg_store.ready;
+    }
+    
+    if(gen1 == 0 || (gen0 != 0 && (int16_t)(gen0 - gen1) > 0)) {
+        cfg_store.page_addr = CFG_STORE_PAGE0_ADDR;
+        cfg_store.generation = gen0;
+    } else {
+        cfg_store.page_addr = CFG_STORE_PAGE1_ADDR;
+        cfg_store.generation = gen1;
+    }
+    
+    cfg_store.next_slot = cfg_find_next_slot(cfg_store.page_addr);
+    cfg_store.ready = 1;
+    return 1;
+}
+
+uint8_t cfg_store_read(cfg_record_type_t type, uint16_t* payload) {
+    uint16_t record[CFG_RECORD_WORDS];
+    
+    if(!cfg_store.ready ||
+       !cfg_find_record(cfg_store.page_addr, cfg_store.next_slot, type, record)) {
+        return 0;
+    }
+    
+    memcpy(payload, &record[1], CFG_RECORD_PAYLOAD_WORDS * sizeof(uint16_t));
+    return 1;
+}
+
+// Page full: erase the other page, carry over the newest record of every
+// other type, append the new record, then write the header. The old page
+// stays the newest until that header exists, so a reset mid-rotation
+// loses nothing
+static uint8_t cfg_rotate_page(uint8_t new_type, const uint16_t* new_payload) {
+    uint32_t old_page = cfg_store.page_addr;
+    uint32_t new_page = (old_page == CFG_STORE_PAGE0_ADDR) ? CFG_STORE_PAGE1_ADDR : CFG_STORE_PAGE0_ADDR;
+    uint16_t generation = cfg_store.generation + 1;
+    uint16_t slot = 1;
+    uint16_t record[CFG_RECORD_WORDS];
+    
+    if(generation == 0) {
+        generation = 1;     // 0 means unformatted
+    }
+    
+    if(!flash_erase_page(new_page)) {
+        return 0;
+    }
+    
+    for(uint8_t type = CFG_TYPE_PAGE + 1; type < CFG_TYPE_COUNT; type++) {
+        if(type != new_type &&
+           cfg_find_record(old_page, cfg_store.next_slot, type, record)) {
+            if(!cfg_write_slot(new_page, slot, type, &record[1])) {
+                return 0;
+            }
+            slot++;
+        }
+    }
+    
+    if(!cfg_write_slot(new_page, slot, new_type, new_payload)) {
+        return 0;
+    }
+    slot++;
+    
+    // Header last: the page only becomes newest once complete
+    uint16_t header[CFG_RECORD_PAYLOAD_WORDS];
+    memset(header, 0xFF, sizeof(header));
+    header[0] = generation;
+    if(!cfg_write_slot(new_page, 0, CFG_TYPE_PAGE, header)) {
+        return 0;
+    }
+    
+    cfg_store.page_addr = new_page;
+    cfg_store.generation = generation;
+    cfg_store.next_slot = slot;
+    return 1;
+}
+
+#ifndef FIRMWARE_BUILD_ID
+#define FIRMWARE_BUILD_ID   __DATE__ " " __TIME__
+#endif
+
+// A few cycles per character at boot, where hashing the program flash took
+// ~10 ms. The fallback ID only changes when this file is rebuilt, so a
+// build that must re-run the self-tests passes its own ID or builds clean
+uint32_t firmware_build_id(void) {
+    const char* id = FIRMWARE_BUILD_ID;
+    uint32_t hash = 2166136261UL;
+    
+    while(*id) {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Append a record unless the newest one of that type is identical
+uint8_t cfg_store_write(cfg_record_type_t type, const uint16_t* payload) {
+    uint16_t current[CFG_RECORD_PAYLOAD_WORDS];
+    
+    if(!cfg_store.ready) {
+        return 0;
+    }
+    if(cfg_store_read(type, current) &&
+       memcmp(current, payload, sizeof(current)) == 0) {
+        return 1;
+    }
+    
+    if(cfg_store.next_slot >= CFG_SLOTS_PER_PAGE) {
+        return cfg_rotate_page(type, payload);
+    }
+    
+    // The slot is consumed once verified. A failed write that left any
+    // word programmed is stepped over too: it cannot be programmed again
+    // before the page is erased. An untouched slot is retried next time
+    uint16_t slot = cfg_store.next_slot;
+    if(cfg_write_slot(cfg_store.page_addr, slot, type, payload)) {
+        cfg_store.next_slot = slot + 1;
+        return 1;
+    }
+    if(!cfg_slot_erased(cfg_store.page_addr, slot)) {
+        cfg_store.next_slot = slot + 1;
+    }
+    return 0;
+}
+
 // =============================================================================
 // CONFIGURATION FUNCTIONS
 // =============================================================================
 
+#define CFG_BEACON_LAYOUT_VERSION   1
+
+static void pack_beacon_config(const beacon_config_2g_t* cfg, uint16_t* payload) {
+    memset(payload, 0xFF, CFG_RECORD_PAYLOAD_WORDS * sizeof(uint16_t));
+    payload[0] = CFG_BEACON_LAYOUT_VERSION;
+    payload[1] = cfg->generation | ((uint16_t)cfg->test_mode << 8);
+    payload[2] = cfg->rotating_type | ((uint16_t)cfg->protocol_code << 8);
+    payload[3] = (uint16_t)cfg->beacon_id;
+    payload[4] = (uint16_t)(cfg->beacon_id >> 16);
+    payload[5] = cfg->country_code;
+    for(uint8_t i = 0; i < 4; i++) {
+        payload[6 + i] = (uint16_t)(cfg->vessel_id >> (16 * i));
+    }
+}
+
+static uint8_t unpack_beacon_config(const uint16_t* payload, beacon_config_2g_t* cfg) {
+    if(payload[0] != CFG_BEACON_LAYOUT_VERSION || (payload[1] & 0xFF) != 2) {
+        return 0;
+    }
+    
+    cfg->generation = payload[1] & 0xFF;
+    cfg->test_mode = payload[1] >> 8;
+    cfg->rotating_type = (rotating_field_type_2g_t)(payload[2] & 0xFF);
+    cfg->protocol_code = payload[2] >> 8;
+    cfg->beacon_id = ((uint32_t)payload[4] << 16) | payload[3];
+    cfg->country_code = payload[5];
+    cfg->vessel_id = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        cfg->vessel_id |= (uint64_t)payload[6 + i] << (16 * i);
+    }
+    return 1;
+}
+
 void load_beacon_configuration_2g(void) {
-    // TODO: Read from EEPROM/Flash
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    
     DEBUG_LOG_FLUSH("Loading beacon configuration...\r\n");
-    // For now, use defaults already set
+    
+    if(!cfg_store_init()) {
+        DEBUG_LOG_FLUSH("Config store unavailable - using defaults\r\n");
+        return;
+    }
+    
+    if(cfg_store_read(CFG_TYPE_BEACON, payload) &&
+       unpack_beacon_config(payload, &beacon_config_2g)) {
+        DEBUG_LOG_FLUSH("Beacon configuration loaded from flash\r\n");
+    } else {
+        DEBUG_LOG_FLUSH("No stored configuration - using defaults\r\n");
+    }
+}
+
+void save_beacon_configuration_2g(void) {
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    pack_beacon_config(&beacon_config_2g, payload);
+    
+    if(cfg_store_write(CFG_TYPE_BEACON, payload)) {
+        DEBUG_LOG_FLUSH("Beacon configuration saved\r\n");
+    } else {
+        DEBUG_LOG_FLUSH("ERROR: Beacon configuration save failed\r\n");
+    }
 }
 
 beacon_config_2g_t* get_beacon_config_2g(void) {
@@ -326,6 +924,7 @@ void start_elt_sequence_2g(void) {
     elt_state_2g.transmission_count = 0;
     elt_state_2g.last_tx_time = 0;
     elt_state_2g.phase_start_time = get_system_time_ms();
+    elt_rng_seed_2g(&elt_state_2g.rng_state, &beacon_config_2g);
     
     DEBUG_LOG_FLUSH("ELT sequence started - Phase 1 (5s intervals)\r\n");
 }
@@ -343,7 +942,7 @@ uint32_t get_current_interval_2g(void) {
             return ELT_PHASE2_INTERVAL;  // 10 seconds
         case ELT_PHASE_3:
             // 28.5s ±1.5s randomization
-            return ELT_PHASE3_INTERVAL + (rand() % (ELT_PHASE3_RANDOM * 2)) - ELT_PHASE3_RANDOM;
+            return ELT_PHASE3_INTERVAL + elt_interval_dither_2g(&elt_state_2g.rng_state);
         default:
             return TEST_INTERVAL;       // 10 seconds for test
     }
@@ -375,28 +974,108 @@ void check_phase_transition_2g(void) {
     }
 }
 
+// =============================================================================
+// ELT INTERVAL DITHER
+// =============================================================================
+
+// Dither span in ms (-ELT_PHASE3_RANDOM..+ELT_PHASE3_RANDOM inclusive) and the
+// rejection threshold that makes the 16-bit multiply-shift reduction unbiased
+#define ELT_DITHER_SPAN         (2U * ELT_PHASE3_RANDOM + 1U)
+#define ELT_DITHER_REJECT       (uint16_t)(65536UL % ELT_DITHER_SPAN)
+
+// 32-bit avalanche (murmur3 finalizer), seeding only
+static uint32_t elt_rng_mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return h;
+}
+
+// Seed from every field of the 23 HEX ID, so two beacons only share a
+// sequence if they also share an ID
+void elt_rng_seed_2g(uint32_t* state, const beacon_config_2g_t* cfg) {
+    uint32_t h = elt_rng_mix32(((uint32_t)cfg->country_code << 16) ^ cfg->protocol_code ^
+                               (uint32_t)(cfg->vessel_id >> 32));
+    h = elt_rng_mix32(h ^ (uint32_t)cfg->vessel_id);
+    h = elt_rng_mix32(h ^ cfg->beacon_id);
+    
+    *state = h ? h : 0x6D2B79F5UL;  // xorshift must never hold 0
+}
+
+// xorshift32 (13, 17, 5): period 2^32 - 1, shifts and XORs only
+uint32_t elt_rng_next_2g(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Uniform dither in ms over [-ELT_PHASE3_RANDOM, +ELT_PHASE3_RANDOM]. Top 16
+// bits times the span (one 16x16 multiply), rejecting the low slice that
+// would over-weight some values (~4% redraws)
+int16_t elt_interval_dither_2g(uint32_t* state) {
+    uint32_t m;
+    
+    do {
+        m = (uint32_t)(uint16_t)(elt_rng_next_2g(state) >> 16) * ELT_DITHER_SPAN;
+    } while((uint16_t)m < ELT_DITHER_REJECT);
+    
+    return (int16_t)(m >> 16) - ELT_PHASE3_RANDOM;
+}
+
+// Known values from state 1: the xorshift32 sequence and the dither drawn
+// from it. The distribution over millions of draws is a host test
+// (tools/host_tests/test_elt_rng.c)
+uint8_t test_elt_interval_rng_2g(void) {
+    static const uint32_t xorshift_ref[3] = {270369UL, 67634689UL, 2647435461UL};
+    static const int16_t dither_ref[3] = {-1500, -1453, 349};
+    uint32_t state = 1;
+    uint8_t ok = 1;
+    
+    DEBUG_LOG_FLUSH("Testing ELT interval dither...\r\n");
+    
+    for(uint8_t n = 0; n < 3; n++) {
+        ok &= (elt_rng_next_2g(&state) == xorshift_ref[n]);
+    }
+    state = 1;
+    for(uint8_t n = 0; n < 3; n++) {
+        ok &= (elt_interval_dither_2g(&state) == dither_ref[n]);
+    }
+    
+    DEBUG_LOG_FLUSH(ok ? "ELT interval dither test PASSED\r\n" : "ELT interval dither test FAILED\r\n");
+    
+    return ok;
+}
+
 // =============================================================================
 // ROTATING FIELD CONFIGURATION
 // =============================================================================
 
+// Frame counter for loss measurement, spare bits stay 0 otherwise
+static uint32_t rotating_field_sequence(void) {
+    return (TEST_CONTINUOUS_MODE && beacon_config_2g.test_mode) ? frame_sequence_2g : 0;
+}
+
 void prepare_rotating_field_data_2g(rotating_field_data_2g_t* rf_data) {
-    rf_data->field_type = beacon_config_2g.rotating_type;
+    fetch_rotating_field_data_2g(rf_data, beacon_config_2g.rotating_type);
+}
+
+// Current source data of one rotating field type
+void fetch_rotating_field_data_2g(rotating_field_data_2g_t* rf_data, rotating_field_type_2g_t rf_type) {
+    rf_data->field_type = rf_type;
     
-    switch(beacon_config_2g.rotating_type) {
+    switch(rf_type) {
         case RF_TYPE_G008_2G:
         case RF_TYPE_ELTDT_2G:
-            {
-                gps_data_t* gps = get_current_gps_data();
-                if(gps && gps->valid) {
-                    rf_data->time_value = encode_time_value_2g(
-                        gps->day, gps->hour, gps->minute, 
-                        beacon_config_2g.rotating_type);
-                    rf_data->altitude_code = encode_altitude_2g(gps->altitude);
-                } else {
-                    rf_data->time_value = 0;
-                    rf_data->altitude_code = encode_altitude_2g(current_altitude_2g);
-                }
-            }
+            // Pre-encoded by the fix cache (time is 0 without a valid fix)
+            gps_fix_cache_update_2g();
+            rf_data->time_value = gps_fix_cache_2g.time_value;
+            rf_data->altitude_code = gps_fix_cache_2g.altitude_code;
+            rf_data->sequence = rotating_field_sequence();
             break;
             
         case RF_TYPE_RLS_2G:
@@ -420,6 +1099,130 @@ const char* get_rotating_field_name_2g(rotating_field_type_2g_t rf_type) {
     }
 }
 
+// =============================================================================
+// ROTATING FIELD SCHEDULER
+// =============================================================================
+
+// Rotating block and the parity after it: contiguous, one pack per frame
+static const frame_field_desc_t rf_sched_block_fields[] = {
+    { 140, 14, FIELD_SPARE      },      // 141-154 Spare
+    { 154, 48, FIELD_RF_PAYLOAD },      // 155-202 Rotating field type + data
+    { 202, 48, FIELD_BCH_PARITY },      // BCH parity (codeword only)
+};
+
+// Invalid types are dropped; an empty cycle falls back to G008
+void rf_sched_configure_2g(const rotating_field_type_2g_t* cycle, uint8_t length) {
+    rf_sched_2g.length = 0;
+    for(uint8_t i = 0; i < length && rf_sched_2g.length < RF_SCHED_MAX_CYCLE; i++) {
+        if(cycle[i] <= RF_TYPE_CANCEL_2G) {
+            rf_sched_2g.cycle[rf_sched_2g.length++] = cycle[i];
+        }
+    }
+    if(rf_sched_2g.length == 0) {
+        rf_sched_2g.cycle[0] = RF_TYPE_G008_2G;
+        rf_sched_2g.length = 1;
+    }
+    rf_sched_2g.position = 0;
+    rf_sched_invalidate_2g();
+}
+
+// Forces every block to be re-encoded (RLS and Cancel sources change only
+// through here)
+void rf_sched_invalidate_2g(void) {
+    for(uint8_t t = 0; t < RF_SCHED_NUM_TYPES; t++) {
+        rf_sched_2g.entries[t].valid = 0;
+    }
+    rf_sched_2g.main_valid = 0;
+}
+
+static uint8_t rf_sched_entry_stale(rotating_field_type_2g_t rf_type) {
+    const rf_sched_entry_2g_t* entry = &rf_sched_2g.entries[rf_type];
+    
+    if(!entry->valid) return 1;
+    if(rf_type == RF_TYPE_G008_2G || rf_type == RF_TYPE_ELTDT_2G) {
+        return entry->fix_stamp != gps_fix_cache_2g.refresh_count ||
+               entry->sequence != rotating_field_sequence();
+    }
+    return 0;
+}
+
+// Pack one type's block into an otherwise zero field, keep it as two words
+// and take the parity of that span alone
+static void rf_sched_encode(rotating_field_type_2g_t rf_type) {
+    rf_sched_entry_2g_t* entry = &rf_sched_2g.entries[rf_type];
+    const frame_layout_t* rotating = frame_rotating_layout(rf_type);
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint8_t block[FRAME_INFO_BYTES];
+    
+    memset(values, 0, sizeof(values));
+    memset(block, 0, sizeof(block));
+    frame_gather_rotating_fields(values, rf_type);
+    frame_pack_fields(block, &frame_main_fields[FIELD_SPARE], 2, values);
+    frame_pack_fields(block, rotating->fields, rotating->count, values);
+    
+    entry->sequence = (uint32_t)values[FIELD_RF_SEQUENCE];
+    frame_unpack_fields(block, rf_sched_block_fields, 2, values);
+    entry->spare = (uint16_t)values[FIELD_SPARE];
+    entry->payload = values[FIELD_RF_PAYLOAD];
+    entry->parity = compute_bch_250_202_span(block, FRAME_SPARE_START_BIT,
+                                             INFO_BITS - FRAME_SPARE_START_BIT);
+    entry->fix_stamp = gps_fix_cache_2g.refresh_count;
+    entry->valid = 1;
+    rf_sched_2g.encodes++;
+}
+
+// Re-encode the stale blocks of the cycle, between bursts so the next frame
+// build finds them ready
+void rf_sched_refresh_2g(void) {
+    gps_fix_cache_update_2g();
+    for(uint8_t i = 0; i < rf_sched_2g.length; i++) {
+        if(rf_sched_entry_stale(rf_sched_2g.cycle[i])) {
+            rf_sched_encode(rf_sched_2g.cycle[i]);
+        }
+    }
+}
+
+rotating_field_type_2g_t rf_sched_next_2g(void) {
+    rotating_field_type_2g_t rf_type = rf_sched_2g.cycle[rf_sched_2g.position];
+    
+    if(++rf_sched_2g.position >= rf_sched_2g.length) {
+        rf_sched_2g.position = 0;
+    }
+    return rf_type;
+}
+
+// Packed information field followed by its 48 parity bits (bit 202 on)
+void rf_sched_build_codeword_2g(uint8_t* codeword, rotating_field_type_2g_t rf_type) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    
+    if(rf_type > RF_TYPE_CANCEL_2G) {
+        rf_type = RF_TYPE_G008_2G;
+    }
+    
+    memset(codeword, 0, FRAME_CODEWORD_BYTES);
+    frame_gather_main_fields(values);
+    frame_pack_fields(codeword, frame_main_fields, FIELD_SPARE, values);  // Bits 1-140
+    
+    // Main parity again only when those bits changed (new fix cell or config)
+    if(!rf_sched_2g.main_valid || memcmp(codeword, rf_sched_2g.main_bits, FRAME_MAIN_BYTES) != 0) {
+        memcpy(rf_sched_2g.main_bits, codeword, FRAME_MAIN_BYTES);
+        rf_sched_2g.main_parity = compute_bch_250_202_span(codeword, 0, FRAME_SPARE_START_BIT);
+        rf_sched_2g.main_valid = 1;
+        rf_sched_2g.encodes++;
+    }
+    
+    // Normally already done by rf_sched_refresh_2g after the previous burst
+    if(rf_sched_entry_stale(rf_type)) {
+        rf_sched_encode(rf_type);
+    }
+    
+    const rf_sched_entry_2g_t* entry = &rf_sched_2g.entries[rf_type];
+    values[FIELD_SPARE] = entry->spare;
+    values[FIELD_RF_PAYLOAD] = entry->payload;
+    values[FIELD_BCH_PARITY] = rf_sched_2g.main_parity ^ entry->parity;
+    frame_pack_fields(codeword, rf_sched_block_fields, 3, values);
+}
+
 // =============================================================================
 // STUB FUNCTIONS
 // =============================================================================
@@ -34,35 +34,91 @@ typedef enum {
 // =============================================================================
 
 // Main frame building
-void build_2g_information_field(uint8_t* info_bits);
-void build_2g_complete_frame(uint8_t* info_bits, uint8_t* complete_frame);
 void build_compliant_frame_2g(void);
 
-// Frame components
-void set_23_hex_id_2g(uint8_t* info_bits);
-void encode_location_2g(uint8_t* info_bits, float latitude, float longitude);
-void set_vessel_id_2g(uint8_t* info_bits);
-void set_rotating_field_2g(uint8_t* info_bits, rotating_field_type_2g_t rf_type);
-
 // GPS position encoding (T018 specific)
-uint64_t encode_gps_position_2g(double lat, double lon);
-void encode_location_appendix_c(uint8_t* info_bits, float latitude, float longitude);
+// Fixed-point inputs: 1e-7 degrees (+N/+E), centimetres; out of range saturates
+uint32_t latitude_to_code_2g(int32_t lat_e7);
+uint32_t longitude_to_code_2g(int32_t lon_e7);
+uint64_t encode_gps_position_2g(int32_t lat_e7, int32_t lon_e7);
+void encode_location_appendix_c(uint8_t* info_bits, int32_t lat_e7, int32_t lon_e7);
+uint8_t test_position_encoding_2g(void);
 
 // 23 HEX ID generation (T018 Appendix B.2)
 void generate_23hex_id_2g(const uint8_t *frame_202bits, char *hex_id);
+const char* beacon_hex_id_2g(void);     // Current configuration, cached
 void build_23hex_from_components(uint16_t tac, uint16_t serial, uint16_t country, 
                                 uint8_t protocol, char *hex_id);
 
 // Dynamic field functions
 uint16_t get_last_location_time_2g(void);
-uint16_t altitude_to_code_2g(double altitude);
-uint8_t encode_altitude_2g(float altitude_m);
+uint16_t altitude_to_code_2g(int32_t altitude_cm);
+uint16_t encode_altitude_2g(int32_t altitude_cm);
 uint32_t encode_time_value_2g(uint8_t day, uint8_t hour, uint8_t minute, uint8_t type);
 
 // Vessel ID functions
 uint64_t encode_vessel_id_2g(uint64_t mmsi_or_reg);
 void set_vessel_id_field_2g(uint8_t* info_bits, uint64_t vessel_id);
 
+// =============================================================================
+// FRAME FIELD LAYOUT
+// =============================================================================
+
+// Information field = main field (bits 1-158, rotating field type last)
+// followed by one of the rotating field layouts (bits 159-202). Bit n of
+// T.018 is bit (n - 1) of the packed buffer, MSB first. Each layout is
+// sorted and gap-free so packing is a single pass of whole-byte writes
+
+// Field sources (index into the value array of the packer/unpacker)
+typedef enum {
+    FIELD_TAC = 0,
+    FIELD_SERIAL,
+    FIELD_COUNTRY,
+    FIELD_PROTOCOL,
+    FIELD_LATITUDE,
+    FIELD_LONGITUDE,
+    FIELD_VESSEL_ID,
+    FIELD_BEACON_TYPE,
+    FIELD_SPARE,
+    FIELD_RF_TYPE,
+    FIELD_MAIN_COUNT,               // Main field entries are in source order
+    FIELD_RF_TIME = FIELD_MAIN_COUNT,
+    FIELD_RF_ALTITUDE,
+    FIELD_RF_SEQUENCE,
+    FIELD_RLS_PROVIDER,
+    FIELD_RLS_DATA,
+    FIELD_CANCEL_METHOD,
+    FIELD_CANCEL_FIXED,
+    FIELD_RF_PAYLOAD,               // Type + rotating data as one value (scheduler)
+    FIELD_BCH_PARITY,               // Parity after the information field
+    FIELD_NUM_SOURCES
+} frame_field_source_t;
+
+typedef struct {
+    uint8_t start;                  // First bit (0-based)
+    uint8_t width;                  // 1-64 bits
+    uint8_t source;                 // frame_field_source_t
+} frame_field_desc_t;
+
+typedef struct {
+    const frame_field_desc_t* fields;
+    uint8_t count;
+} frame_layout_t;
+
+#define FRAME_INFO_BYTES            ((INFO_BITS + 7) / 8)
+#define FRAME_CODEWORD_BYTES        ((INFO_BITS + BCH_PARITY_BITS + 7) / 8)
+#define FRAME_SPARE_START_BIT       140     // First bit that depends on the rotating type
+#define FRAME_ROTATING_START_BIT    158
+
+extern const frame_layout_t frame_main_layout;
+const frame_layout_t* frame_rotating_layout(rotating_field_type_2g_t rf_type);
+
+void frame_pack_fields(uint8_t* info_bits, const frame_field_desc_t* fields, uint8_t count,
+                       const uint64_t* values);
+void frame_unpack_fields(const uint8_t* info_bits, const frame_field_desc_t* fields, uint8_t count,
+                         uint64_t* values);
+void frame_gather_fields_2g(uint64_t* values);
+
 // =============================================================================
 // T018 BEACON CONFIGURATION
 // =============================================================================
@@ -84,6 +140,7 @@ typedef struct {
     uint16_t transmission_count;
     uint32_t last_tx_time;
     uint32_t phase_start_time;
+    uint32_t rng_state;         // Phase 3 dither generator (xorshift32)
     uint8_t active;
 } elt_state_2g_t;
 
@@ -98,6 +155,7 @@ typedef struct {
         struct {    // G008/ELTDT
             uint32_t time_value;
             uint16_t altitude_code;
+            uint32_t sequence;      // Spare bits, continuous TEST mode only
         };
         struct {    // RLS
             uint8_t rls_provider;
@@ -109,6 +167,136 @@ typedef struct {
     };
 } rotating_field_data_2g_t;
 
+// =============================================================================
+// ROTATING FIELD SCHEDULER
+// =============================================================================
+
+// Rotating field type per burst from a configured cycle. Every type in the
+// cycle keeps its block (spare + 48-bit rotating field) pre-encoded with the
+// block's BCH parity contribution, and the main fields' contribution is
+// cached on their packed bits. The code is linear, so the frame parity is the
+// XOR of the two and a burst's rotating field is a table lookup
+#define RF_SCHED_MAX_CYCLE      8
+#define RF_SCHED_NUM_TYPES      (RF_TYPE_CANCEL_2G + 1)
+#define FRAME_MAIN_BYTES        ((FRAME_SPARE_START_BIT + 7) / 8)
+
+typedef struct {
+    uint64_t payload;           // Bits 155-202: type (4) + rotating data (44)
+    uint64_t parity;            // BCH contribution of bits 141-202
+    uint16_t spare;             // Bits 141-154 (all 1s with Cancel)
+    uint16_t fix_stamp;         // Fix cache refresh_count at encode (G008/ELT-DT)
+    uint32_t sequence;          // Continuous TEST sequence at encode (G008/ELT-DT)
+    uint8_t valid;
+} rf_sched_entry_2g_t;
+
+typedef struct {
+    rotating_field_type_2g_t cycle[RF_SCHED_MAX_CYCLE];
+    uint8_t length;
+    uint8_t position;                       // Cycle slot of the next burst
+    rf_sched_entry_2g_t entries[RF_SCHED_NUM_TYPES];
+    uint8_t main_bits[FRAME_MAIN_BYTES];    // Packed bits 1-140 of main_parity
+    uint64_t main_parity;                   // BCH contribution of bits 1-140
+    uint8_t main_valid;
+    uint16_t encodes;                       // Block and main parity re-encodes
+} rf_scheduler_2g_t;
+
+void rf_sched_configure_2g(const rotating_field_type_2g_t* cycle, uint8_t length);
+void rf_sched_invalidate_2g(void);
+void rf_sched_refresh_2g(void);
+rotating_field_type_2g_t rf_sched_next_2g(void);
+void rf_sched_build_codeword_2g(uint8_t* codeword, rotating_field_type_2g_t rf_type);
+
+// =============================================================================
+// FRAME DECODER
+// =============================================================================
+
+// Information field read back into its components (inverse of the
+// frame packer). Location and altitude are the centres of the
+// encoded cells. No global state: safe for bulk decoding on a host build
+typedef struct {
+    uint16_t tac;
+    uint16_t serial;
+    uint16_t country;
+    uint8_t protocol;
+    uint8_t beacon_type;
+    uint16_t spare;
+    uint32_t lat_code;
+    uint32_t lon_code;
+    int32_t latitude_e7;
+    int32_t longitude_e7;
+    uint64_t vessel_id;
+    rotating_field_data_2g_t rotating;  // Payload of rotating.field_type
+    int32_t altitude_cm;                // G008/ELT-DT only
+    uint8_t well_formed;                // Known rotating type, fixed bits as specified
+    char hex_id[24];
+} frame_decoded_2g_t;
+
+uint8_t frame_decode_2g(const uint8_t* info_bits, frame_decoded_2g_t* frame);
+void format_23hex_id_2g(const frame_decoded_2g_t* frame, char* hex_id);
+
+// =============================================================================
+// GPS FIX CACHE
+// =============================================================================
+
+// Pre-encoded location, altitude and time fields. A new fix is re-encoded
+// only when it leaves the input range (cell) that maps to the cached codes
+typedef struct {
+    uint8_t initialized;
+    uint8_t gps_valid;          // Codes come from a valid GPS fix (else fallback)
+    uint32_t lat_code;          // 23-bit latitude field
+    uint32_t lon_code;          // 24-bit longitude field
+    uint16_t altitude_code;     // Rotating field altitude code
+    uint32_t time_value;        // Rotating field time value
+    int32_t lat_lo_e7;          // Latitude cell [lo, hi) in 1e-7 degrees
+    int32_t lat_hi_e7;
+    int32_t lon_lo_e7;          // Longitude cell [lo, hi) in 1e-7 degrees
+    int32_t lon_hi_e7;
+    int32_t alt_lo_cm;          // Altitude cell [lo, hi) in centimetres
+    int32_t alt_hi_cm;
+    uint8_t day, hour, minute;  // Inputs of time_value
+    uint16_t refresh_count;     // Number of re-encodes since boot
+} gps_fix_cache_2g_t;
+
+uint8_t gps_fix_cache_update_2g(void);
+void gps_fix_cache_invalidate_2g(void);
+
+// =============================================================================
+// CONFIGURATION STORE (log-structured, program flash)
+// =============================================================================
+
+// Two reserved erase pages used alternately. Each page is a log of fixed
+// 16-word slots: slot 0 holds the page header (generation), records are
+// appended after it and never rewritten. Record: magic|type, payload, CRC
+#define CFG_STORE_PAGE0_ADDR        0x9800UL
+#define CFG_STORE_PAGE1_ADDR        (CFG_STORE_PAGE0_ADDR + FLASH_PAGE_SIZE_ADDR)
+#define CFG_RECORD_WORDS            16      // Even: written as double words
+#define CFG_RECORD_PAYLOAD_WORDS    (CFG_RECORD_WORDS - 2)
+#define CFG_SLOTS_PER_PAGE          (uint16_t)(FLASH_PAGE_SIZE_ADDR / (2 * CFG_RECORD_WORDS))
+#define CFG_RECORD_MAGIC            0xC500
+
+typedef enum {
+    CFG_TYPE_PAGE = 0x01,           // Page header, payload[0] = generation
+    CFG_TYPE_BEACON = 0x02,         // beacon_config_2g
+    CFG_TYPE_POST = 0x03,           // Cached self-test results + calibration
+    CFG_TYPE_COUNT
+} cfg_record_type_t;
+
+typedef struct {
+    uint32_t page_addr;             // Active page
+    uint16_t generation;            // Page erase generation (wear count)
+    uint16_t next_slot;             // First erased slot (CFG_SLOTS_PER_PAGE = full)
+    uint8_t ready;
+} cfg_store_t;
+
+uint8_t cfg_store_init(void);
+uint8_t cfg_store_read(cfg_record_type_t type, uint16_t* payload);
+uint8_t cfg_store_write(cfg_record_type_t type, const uint16_t* payload);
+
+// Identity of the firmware build for keying cached records: FNV-1a over the
+// build ID string. A build may pass its own (-DFIRMWARE_BUILD_ID="...");
+// otherwise the date and time protocol_data.c was compiled stand in for it
+uint32_t firmware_build_id(void);
+
 // =============================================================================
 // T018 CONFIGURATION FUNCTIONS
 // =============================================================================
@@ -128,8 +316,16 @@ void stop_elt_sequence_2g(void);
 uint32_t get_current_interval_2g(void);
 void check_phase_transition_2g(void);
 
+// Phase 3 interval dither: xorshift32 seeded from the beacon identity, so
+// units differ but one unit replays the same sequence (host simulation)
+void elt_rng_seed_2g(uint32_t* state, const beacon_config_2g_t* cfg);
+uint32_t elt_rng_next_2g(uint32_t* state);
+int16_t elt_interval_dither_2g(uint32_t* state);
+uint8_t test_elt_interval_rng_2g(void);
+
 // Rotating field configuration
 void prepare_rotating_field_data_2g(rotating_field_data_2g_t* rf_data);
+void fetch_rotating_field_data_2g(rotating_field_data_2g_t* rf_data, rotating_field_type_2g_t rf_type);
 const char* get_rotating_field_name_2g(rotating_field_type_2g_t rf_type);
 
 // Stub functions for external data
@@ -139,20 +335,89 @@ uint8_t get_deactivation_method_2g(void);
 uint64_t get_configured_vessel_id_2g(void);
 
 // =============================================================================
-// GLOBAL FRAME BUFFER
+// FRAME ARENA
+// =============================================================================
+
+// All frame-sized buffers live in one statically planned arena. Each phase
+// owns a region, and regions of phases that never run at the same time share
+// bytes:
+//   build     - frame assembly (TX job, main context)
+//   transmit  - burst on air (spread bits and PRN chip tables)
+//   self-test - POST scratch (boot or selftest job)
+// The build region has its own bytes: the next frame is assembled while the
+// current one is on air, and in continuous TX mode a prebuilt frame stays
+// there across the deferred selftest job. A burst runs to completion inside
+// the TX job and the selftest job is a separate job, so self-test overlays
+// the transmit region
+typedef struct {
+    uint8_t info[FRAME_CODEWORD_BYTES];     // Packed information field + BCH parity
+} frame_build_region_t;
+
+typedef struct {
+    uint8_t frame_bits[FRAME_TOTAL_BITS];   // Preamble + info + BCH
+    int8_t prn_i[SPREADING_FACTOR];         // I chips for one bit
+    int8_t prn_q[SPREADING_FACTOR];         // Q chips for one bit
+    uint16_t chip_queue[SPI_CHIP_QUEUE_SIZE][2]; // MCP4922 I/Q words, CCP1 ISR ring
+} frame_tx_region_t;
+
+typedef struct {
+    int8_t prn_i[SPREADING_FACTOR];         // PRN verification sequences
+    int8_t prn_q[SPREADING_FACTOR];
+    uint8_t bch_info[INFO_BITS];            // BCH known-answer input
+} frame_selftest_region_t;
+
+typedef struct {
+    frame_build_region_t build;
+    union {
+        frame_tx_region_t tx;
+        frame_selftest_region_t selftest;
+    } shared;
+} frame_arena_t;
+
+// Region sizes
+#define FRAME_ARENA_BUILD_BYTES     (sizeof(frame_build_region_t))
+#define FRAME_ARENA_TX_BYTES        (sizeof(frame_tx_region_t))
+#define FRAME_ARENA_SELFTEST_BYTES  (sizeof(frame_selftest_region_t))
+#define FRAME_ARENA_BUDGET_BYTES    1200
+
+// Build-time RAM plan: peak arena bytes of each phase, counting every region
+// live while it runs, against the phase budget. Each row is a static assert
+// in protocol_data.c, so a phase over budget fails the build by name; the
+// host tests print the table (make -C tools/host_tests check). Build counts
+// the transmit region, since a burst may be on air; self-test counts a
+// prebuilt frame in the build region but never a burst
+//      phase       peak bytes                                          budget
+#define FRAME_ARENA_PHASES(PHASE) \
+    PHASE(build,    FRAME_ARENA_BUILD_BYTES + FRAME_ARENA_TX_BYTES,     1200) \
+    PHASE(transmit, FRAME_ARENA_TX_BYTES,                               1100) \
+    PHASE(selftest, FRAME_ARENA_BUILD_BYTES + FRAME_ARENA_SELFTEST_BYTES, 800)
+
+// Compile-time check: fails the build with a negative array size
+#define FRAME_ARENA_STATIC_ASSERT(cond, name) \
+    typedef char frame_arena_assert_##name[(cond) ? 1 : -1]
+
+extern frame_arena_t frame_arena;
+
+// Legacy names for the build region
+#define frame_2g_info       (frame_arena.build.info)
+
+void frame_arena_report(void);
+
+// =============================================================================
+// GLOBAL STATE
 // =============================================================================
 
-// Global frame buffers
-extern uint8_t beacon_frame_2g[252];        // Complete frame with header+BCH
-extern uint8_t frame_2g_info[202];          // Information field only
 extern beacon_config_2g_t beacon_config_2g;
 extern elt_state_2g_t elt_state_2g;
+extern gps_fix_cache_2g_t gps_fix_cache_2g;
+extern rf_scheduler_2g_t rf_sched_2g;
 
 // System state variables
 extern uint32_t system_time_2g;
+extern uint32_t frame_sequence_2g;
 extern uint32_t last_update_2g;
-extern float current_latitude_2g;
-extern float current_longitude_2g;
-extern float current_altitude_2g;
+extern int32_t current_latitude_e7_2g;
+extern int32_t current_longitude_e7_2g;
+extern int32_t current_altitude_cm_2g;
 
 #endif /* PROTOCOL_DATA_H */
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "rf_interface.h"
 #include "system_debug.h"
+#include "protocol_data.h"
 
 // =============================================================================
 // GLOBAL RF STATE
@@ -12,6 +13,45 @@
 
 static rf_status_t rf_status = {0, 0, RF_POWER_OFF, 0, 0};
 static rf_calibration_t rf_calibration = {2048, 2048, 1.0, 1.0, 0};
+static adf7012_shadow_t adf_shadow = {{0}, 0, 0, 0, 0};
+static rf_enable_timing_t rf_enable_timing = {0, 0, 0};
+static rf_lock_stats_t rf_lock_stats = {0, 0, 0, 0, 0, 0};
+
+// Bring-up state, advanced by the lock-detect ISR
+static volatile rf_bringup_state_t rf_bringup_state = RF_BRINGUP_OFF;
+static volatile uint32_t rf_lock_edge_us = 0;
+static uint32_t rf_lock_start_us = 0;
+static uint8_t rf_lock_measuring = 0;
+static uint32_t adf4351_regs[ADF4351_NUM_REGS] = {0};
+static uint8_t adf4351_valid = 0;      // Bit n: adf4351_regs[n] latched in the device
+
+// SPI scheduler: free-running 16-bit head/tail counters, producer in the
+// main loop, consumer in the CCP1 ISR (16-bit accesses are atomic)
+static volatile uint8_t spi_stream_on = 0;
+static volatile uint8_t spi_stream_draining = 0;
+static volatile uint16_t spi_chip_head = 0;
+static volatile uint16_t spi_chip_tail = 0;
+static spi_bg_transaction_t spi_bg_queue[SPI_BG_QUEUE_SIZE];
+static volatile uint16_t spi_bg_head = 0;
+static volatile uint16_t spi_bg_tail = 0;
+static spi_sched_stats_t spi_sched_stats = {0, 0, 0, 0, 0, 0};
+
+// Channel plan - every entry is computed and checked by the compiler
+#define SYNTH_CHANNEL_PLAN(CH) \
+    CH(403_000, 403000000UL) \
+    CH(403_025, 403025000UL) \
+    CH(403_050, 403050000UL) \
+    CH(406_025, 406025000UL)
+
+#define SYNTH_TABLE_ENTRY(name, f)  [SYNTH_CH_##name] = SYNTH_CHANNEL(f),
+static const synth_channel_t synth_channel_table[SYNTH_NUM_CHANNELS] = {
+    SYNTH_CHANNEL_PLAN(SYNTH_TABLE_ENTRY)
+};
+
+// Fails the build (negative array size) on a channel off the plan
+#define SYNTH_PLAN_ASSERT(name, f) \
+    typedef char synth_plan_assert_##name[SYNTH_CHANNEL_VALID(f) ? 1 : -1];
+SYNTH_CHANNEL_PLAN(SYNTH_PLAN_ASSERT)
 
 // =============================================================================
 // RF INTERFACE INITIALIZATION
@@ -27,11 +67,11 @@ void rf_interface_init(void) {
     // Initialize DAC
     mcp4922_init();
     
-    // Initialize RF synthesizer
+    // Initialize RF synthesizer and I/Q modulator LO
     adf7012_init();
+    adf4351_init();
     
-    // Perform calibration
-    rf_calibration_init();
+    // Calibration is run or restored by the startup sequence (main.c)
     
     // Update status
     rf_update_status();
@@ -48,6 +88,20 @@ void rf_configure_pins(void) {
     ADF_CS_TRIS = 0;          // Output
     ADF_CS_LAT = 1;           // CS inactive (high)
     
+    // ADF7012 MUXOUT (digital lock detect), rising edge interrupt
+    ADF_MUXOUT_TRIS = 1;      // Input
+    CNCONBbits.CNSTYLE = 1;   // Edge-style change notification
+    CNEN0Bbits.CNEN0B0 = 1;   // Rising edge on RB0
+    CNCONBbits.ON = 1;
+    IPC0bits.CNBIP = RF_LOCK_ISR_IPL;
+    CNFBbits.CNFB0 = 0;
+    IFS0bits.CNBIF = 0;
+    IEC0bits.CNBIE = 1;
+    
+    // ADF4351 LE pin
+    ADF4351_CS_TRIS = 0;      // Output
+    ADF4351_CS_LAT = 1;       // Idle high (LE rising edge latches)
+    
     // RF amplifier control
     TRISBbits.TRISB15 = 0;    // Output
     LATBbits.LATB15 = 0;      // Initially disabled
@@ -85,7 +139,7 @@ void mcp4922_write_dac_a(uint16_t value) {
     
     spi_select_device(SPI_DEVICE_MCP4922);
     spi_transfer_16(command);
-    spi_select_device(SPI_DEVICE_ADF7012);  // Restore default
+    spi_select_device(SPI_DEVICE_NONE);
 }
 
 void mcp4922_write_dac_b(uint16_t value) {
@@ -94,7 +148,7 @@ void mcp4922_write_dac_b(uint16_t value) {
     
     spi_select_device(SPI_DEVICE_MCP4922);
     spi_transfer_16(command);
-    spi_select_device(SPI_DEVICE_ADF7012);  // Restore default
+    spi_select_device(SPI_DEVICE_NONE);
 }
 
 void mcp4922_write_both(uint16_t i_value, uint16_t q_value) {
@@ -107,11 +161,22 @@ void mcp4922_write_both(uint16_t i_value, uint16_t q_value) {
     mcp4922_write_dac_b(q_value);  // Q channel
 }
 
+// Calibrated DAC A/B command words, for callers that queue them for the
+// chip ISR instead of writing them
+void mcp4922_command_words(uint16_t i_value, uint16_t q_value, uint16_t* i_cmd, uint16_t* q_cmd) {
+    if(rf_calibration.calibrated) {
+        rf_apply_calibration(&i_value, &q_value);
+    }
+    
+    *i_cmd = MCP4922_DAC_A_CMD | (i_value & 0x0FFF);
+    *q_cmd = MCP4922_DAC_B_CMD | (q_value & 0x0FFF);
+}
+
 void mcp4922_shutdown(void) {
     spi_select_device(SPI_DEVICE_MCP4922);
     spi_transfer_16(MCP4922_SHUTDOWN_A);
     spi_transfer_16(MCP4922_SHUTDOWN_B);
-    spi_select_device(SPI_DEVICE_ADF7012);
+    spi_select_device(SPI_DEVICE_NONE);
     
     DEBUG_LOG_FLUSH("MCP4922 shutdown\r\n");
 }
@@ -138,67 +203,255 @@ void mcp4922_test_output(void) {
 // ADF7012 RF SYNTHESIZER IMPLEMENTATION
 // =============================================================================
 
+// Registers are latched in the power-up order: REG3 first
+static const uint8_t adf7012_commit_order[ADF7012_NUM_REGS] = {
+    ADF7012_REG3, ADF7012_REG0, ADF7012_REG1, ADF7012_REG2
+};
+
+#define ADF7012_SYNTH_REGS      ((1 << ADF7012_REG0) | (1 << ADF7012_REG1) | (1 << ADF7012_REG3))
+#define ADF7012_LD_BLANK_US     100     // Lock detect may still read the old lock
+
 void adf7012_init(void) {
     DEBUG_LOG_FLUSH("Initializing ADF7012 RF synthesizer...\r\n");
     
-    // Power-on delay
-    system_delay_ms(10);
-    
-    // Initialize registers (simplified configuration)
-    adf7012_write_register(ADF7012_REG3, 0x0001C7);  // Initialize
-    system_delay_ms(1);
-    
-    adf7012_write_register(ADF7012_REG0, 0x200000);  // Reference setup
-    adf7012_write_register(ADF7012_REG1, 0x80325B);  // N divider for 406MHz
-    adf7012_write_register(ADF7012_REG2, 0x10E42A);  // Function control
-    
-    system_delay_ms(5);  // Allow PLL to lock
-    
-    rf_status.current_frequency = ADF7012_FREQ_406MHZ;
+    // Supply settling runs in parallel with the rest of system_init(),
+    // so only what is left of it is waited for
+    while(get_system_time_us() < ADF7012_POWER_ON_US);
+    
+    // Nothing is known about the device after power-up
+    adf_shadow.valid = 0;
+    adf7012_stage_register(ADF7012_REG3,
+        (ADF7012_REG3_INIT & ~ADF7012_REG3_MUXOUT_MASK) | ADF7012_REG3_MUXOUT_LD);
+    adf7012_stage_register(ADF7012_REG0,
+        (ADF7012_REG0_INIT & ~ADF7012_REG0_R_MASK) | (ADF7012_R_COUNTER << ADF7012_REG0_R_SHIFT));
+    adf7012_stage_register(ADF7012_REG1, synth_channel_table[SYNTH_DEFAULT_CHANNEL].adf7012_reg1);
+    adf7012_stage_register(ADF7012_REG2, ADF7012_REG2_INIT);
+    adf7012_commit();
+    adf7012_wait_lock(ADF7012_LOCK_TIMEOUT_US);
+    
+    rf_status.current_frequency = synth_channel_table[SYNTH_DEFAULT_CHANNEL].frequency_hz;
     DEBUG_LOG_FLUSH("ADF7012 initialized for 406 MHz\r\n");
 }
 
+// Arbitrary frequency: plan channels go through the table, anything else is
+// planned at run time with the same integer arithmetic
 void adf7012_set_frequency(uint32_t frequency) {
-    // Calculate N divider for desired frequency
-    // Simplified calculation - real implementation would be more complex
-    uint32_t n_divider = frequency / 25000;  // Assuming 25kHz reference
-    
-    uint32_t reg1_data = 0x800000 | (n_divider & 0x7FFF);
-    adf7012_write_register(ADF7012_REG1, reg1_data);
+    for(uint8_t ch = 0; ch < SYNTH_NUM_CHANNELS; ch++) {
+        if(synth_channel_table[ch].frequency_hz == frequency) {
+            synth_set_channel((synth_channel_id_t)ch);
+            return;
+        }
+    }
     
-    system_delay_ms(2);  // Allow PLL to lock
+    adf7012_stage_register(ADF7012_REG1, ADF7012_REG1_FOR(frequency));
+    if(adf7012_commit()) {
+        adf7012_wait_lock(ADF7012_LOCK_TIMEOUT_US);
+    }
     rf_status.current_frequency = frequency;
     
-    DEBUG_LOG_FLUSH("ADF7012 frequency set to: ");
-    debug_print_dec(frequency);
-    DEBUG_LOG_FLUSH(" Hz\r\n");
+    DEBUG_EVENT2(MSG_RF_FREQ, frequency & 0xFFFF, frequency >> 16);
 }
 
+// Only the RF enable bit changes: the rest of REG2 is kept from the shadow
 void adf7012_enable_output(uint8_t enable) {
-    uint32_t reg2_data = 0x10E42A;  // Base configuration
+    uint32_t reg2_data = adf_shadow.reg[ADF7012_REG2];
     
     if(enable) {
-        reg2_data |= 0x000008;  // Enable RF output
+        reg2_data |= ADF7012_REG2_RF_ENABLE;
     } else {
-        reg2_data &= ~0x000008; // Disable RF output
+        reg2_data &= ~ADF7012_REG2_RF_ENABLE;
     }
     
-    adf7012_write_register(ADF7012_REG2, reg2_data);
+    adf7012_stage_register(ADF7012_REG2, reg2_data);
+    adf7012_commit();
 }
 
+// Single register write, skipped when the device already holds the value
 void adf7012_write_register(uint8_t reg, uint32_t data) {
-    // Combine register address with data
-    uint32_t spi_data = (data & 0xFFFFFC) | (reg & 0x03);
+    adf7012_stage_register(reg, data);
+    adf7012_commit();
+}
+
+void adf7012_stage_register(uint8_t reg, uint32_t data) {
+    uint8_t bit = 1 << (reg & 0x03);
+    data &= 0xFFFFFC;
+    
+    if((adf_shadow.valid & bit) && !(adf_shadow.dirty & bit) &&
+       adf_shadow.reg[reg & 0x03] == data) {
+        adf_shadow.writes_skipped++;
+        return;
+    }
+    
+    adf_shadow.reg[reg & 0x03] = data;
+    adf_shadow.dirty |= bit;
+}
+
+// Shift out every staged register under one select, pulsing LE high after
+// each word to latch it. Returns the synthesizer registers written (REG0,
+// REG1, REG3), i.e. non-zero when the PLL has to relock
+uint8_t adf7012_commit(void) {
+    uint8_t dirty = adf_shadow.dirty;
+    uint8_t first = 1;
+    
+    if(!dirty) {
+        return 0;
+    }
+    
+    // Burst on air: the words go out one per chip gap, in the same order
+    if(spi_stream_active()) {
+        for(uint8_t i = 0; i < ADF7012_NUM_REGS; i++) {
+            uint8_t reg = adf7012_commit_order[i];
+            if(dirty & (1 << reg)) {
+                spi_submit_background(SPI_DEVICE_ADF7012, adf_shadow.reg[reg] | reg, 32);
+                adf_shadow.words_written++;
+            }
+        }
+        adf_shadow.valid |= dirty;
+        adf_shadow.dirty = 0;
+        return dirty & ADF7012_SYNTH_REGS;
+    }
     
     spi_select_device(SPI_DEVICE_ADF7012);
-    spi_transfer_32(spi_data);
-    spi_select_device(SPI_DEVICE_ADF7012);  // Keep selected as default
+    for(uint8_t i = 0; i < ADF7012_NUM_REGS; i++) {
+        uint8_t reg = adf7012_commit_order[i];
+        if(!(dirty & (1 << reg))) {
+            continue;
+        }
+        if(!first) {
+            ADF_CS_LAT = 0;
+        }
+        spi_transfer_32(adf_shadow.reg[reg] | reg);
+        ADF_CS_LAT = 1;         // LE rising edge latches the word
+        Nop();
+        Nop();                  // LE high time
+        adf_shadow.words_written++;
+        first = 0;
+    }
+    spi_select_device(SPI_DEVICE_NONE);
+    
+    adf_shadow.valid |= dirty;
+    adf_shadow.dirty = 0;
+    
+    return dirty & ADF7012_SYNTH_REGS;
+}
+
+static void rf_lock_record(uint32_t elapsed_us) {
+    uint16_t lock_us = (elapsed_us > 0xFFFF) ? 0xFFFF : (uint16_t)elapsed_us;
+    
+    rf_lock_stats.last_us = lock_us;
+    if(rf_lock_stats.count == 0 || lock_us < rf_lock_stats.min_us) {
+        rf_lock_stats.min_us = lock_us;
+    }
+    if(lock_us > rf_lock_stats.max_us) {
+        rf_lock_stats.max_us = lock_us;
+    }
+    rf_lock_stats.total_us += lock_us;
+    rf_lock_stats.count++;
+}
+
+// Poll MUXOUT (digital lock detect) instead of a fixed settling delay. Used
+// where nothing else can run meanwhile (init, retune)
+uint8_t adf7012_wait_lock(uint32_t timeout_us) {
+    uint32_t start_us = get_system_time_us();
+    uint32_t elapsed_us = 0;
+    
+    __delay_us(ADF7012_LD_BLANK_US);
+    while(!ADF_MUXOUT_PORT) {
+        elapsed_us = get_system_time_us() - start_us;
+        if(elapsed_us >= timeout_us) {
+            rf_lock_stats.timeouts++;
+            rf_status.adf7012_locked = 0;
+            return 0;
+        }
+    }
+    
+    rf_lock_record(get_system_time_us() - start_us);
+    rf_status.adf7012_locked = 1;
+    return 1;
 }
 
 uint8_t adf7012_get_lock_status(void) {
-    // In a real implementation, would read lock detect pin
-    // For now, assume locked after initialization
-    return rf_status.adf7012_locked;
+    return ADF_MUXOUT_PORT;
+}
+
+const adf7012_shadow_t* adf7012_get_shadow(void) {
+    return &adf_shadow;
+}
+
+// =============================================================================
+// ADF4351 LO SYNTHESIZER IMPLEMENTATION
+// =============================================================================
+
+// Registers are programmed REG5 down to REG0: the REG0 write starts the VCO
+// band selection, so a retune only needs REG0. The RF output stays off
+// until the burst bring-up
+void adf4351_init(void) {
+    adf4351_valid = 0;
+    
+    adf4351_write_register(5, ADF4351_LD_PIN_DLD | ADF4351_REG5_RESERVED);
+    adf4351_write_register(4, ADF4351_FB_FUNDAMENTAL | (ADF4351_RF_DIV_SEL << 20) |
+                              ADF4351_BS_CLK_DIV | ADF4351_RF_POWER_5DBM);
+    adf4351_write_register(3, ADF4351_CLK_DIV_150);
+    adf4351_write_register(2, ADF4351_MUXOUT_DLD | (ADF4351_R_COUNTER << 14) |
+                              ADF4351_CP_2_5MA | ADF4351_PD_POSITIVE);
+    adf4351_write_register(1, ADF4351_PRESCALER_89 | ADF4351_PHASE_1 | (ADF4351_MOD << 3));
+    adf4351_write_register(0, synth_channel_table[SYNTH_DEFAULT_CHANNEL].adf4351_reg0);
+    
+    DEBUG_LOG_FLUSH("ADF4351 LO initialized\r\n");
+}
+
+// Change-only write: the device keeps its registers until power is removed
+void adf4351_write_register(uint8_t reg, uint32_t data) {
+    uint8_t bit = 1 << reg;
+    data = (data & ~0x7UL) | reg;
+    
+    if((adf4351_valid & bit) && adf4351_regs[reg] == data) {
+        return;
+    }
+    
+    if(spi_stream_active()) {
+        spi_submit_background(SPI_DEVICE_ADF4351, data, 32);
+    } else {
+        spi_select_device(SPI_DEVICE_ADF4351);
+        spi_transfer_32(data);
+        spi_select_device(SPI_DEVICE_NONE); // LE rising edge latches the word
+    }
+    
+    adf4351_regs[reg] = data;
+    adf4351_valid |= bit;
+}
+
+void adf4351_enable_output(uint8_t enable) {
+    uint32_t reg4_data = adf4351_regs[4];
+    
+    if(enable) {
+        reg4_data |= ADF4351_RF_OUT_ENABLE;
+    } else {
+        reg4_data &= ~ADF4351_RF_OUT_ENABLE;
+    }
+    adf4351_write_register(4, reg4_data);
+}
+
+// =============================================================================
+// SYNTHESIZER CHANNEL PLAN
+// =============================================================================
+
+const synth_channel_t* synth_get_channel(synth_channel_id_t channel) {
+    return &synth_channel_table[channel];
+}
+
+// Retune both parts from the precomputed table: one register each
+void synth_set_channel(synth_channel_id_t channel) {
+    const synth_channel_t* entry = &synth_channel_table[channel];
+    
+    adf4351_write_register(0, entry->adf4351_reg0);
+    adf7012_stage_register(ADF7012_REG1, entry->adf7012_reg1);
+    if(adf7012_commit()) {
+        adf7012_wait_lock(ADF7012_LOCK_TIMEOUT_US);
+    }
+    rf_status.current_frequency = entry->frequency_hz;
+    
+    DEBUG_EVENT2(MSG_RF_FREQ, entry->frequency_hz & 0xFFFF, entry->frequency_hz >> 16);
 }
 
 // =============================================================================
@@ -248,9 +501,146 @@ void rf_set_power_level(rf_power_level_t level) {
             break;
     }
     
-    DEBUG_LOG_FLUSH("RF power level set to: ");
-    debug_print_dec(level);
-    DEBUG_LOG_FLUSH("\r\n");
+    DEBUG_EVENT1(MSG_RF_POWER, level);
+}
+
+// Burst RF path for callers that do not overlap anything with the lock:
+// bring-up and wait in one call. Returns 0 when the PLL did not lock
+uint8_t rf_enable_carrier(uint8_t enable) {
+    if(!enable) {
+        rf_bringup_stop();
+        return 0;
+    }
+    
+    if(rf_bringup_state == RF_BRINGUP_OFF || rf_bringup_state == RF_BRINGUP_FAILED) {
+        rf_bringup_start();
+    }
+    return rf_bringup_wait_ready();
+}
+
+// =============================================================================
+// RF BRING-UP
+// =============================================================================
+
+// ADF7012 lock detect rising edge: the amplifier goes on right away so its
+// settling also overlaps the frame build
+void __attribute__((__interrupt__, __auto_psv__)) _CNBInterrupt(void) {
+    ISR_ENTER(ISR_ID_CNB);
+    
+    if(CNFBbits.CNFB0) {
+        CNFBbits.CNFB0 = 0;
+        if(rf_bringup_state == RF_BRINGUP_LOCKING && ADF_MUXOUT_PORT) {
+            rf_lock_edge_us = get_system_time_us();
+            AMP_ENABLE_PIN = 1;
+            rf_bringup_state = RF_BRINGUP_READY;
+        }
+    }
+    
+    IFS0bits.CNBIF = 0;
+    ISR_EXIT();
+}
+
+// Burst trigger: power the PLL and enable the RF outputs, then return
+void rf_bringup_start(void) {
+    uint32_t now_us = get_system_time_us();
+    
+    rf_enable_timing.trigger_us = now_us;
+    rf_lock_start_us = now_us;
+    rf_bringup_state = RF_BRINGUP_LOCKING;
+    
+    adf4351_enable_output(1);
+    adf7012_stage_register(ADF7012_REG3, adf_shadow.reg[ADF7012_REG3] | ADF7012_REG3_PLL_ENABLE);
+    adf7012_stage_register(ADF7012_REG2, adf_shadow.reg[ADF7012_REG2] | ADF7012_REG2_RF_ENABLE);
+    rf_lock_measuring = (adf7012_commit() != 0);
+    
+    // PLL was left running and is still locked: no edge will come
+    if(!rf_lock_measuring && ADF_MUXOUT_PORT) {
+        rf_lock_edge_us = now_us;
+        AMP_ENABLE_PIN = 1;
+        rf_bringup_state = RF_BRINGUP_READY;
+    }
+}
+
+// Called right before the first chip. Returns 1 with the carrier on, 0 when
+// the PLL did not lock in time (amplifier left off)
+uint8_t rf_bringup_wait_ready(void) {
+    uint32_t deadline_us = rf_lock_start_us + ADF7012_LOCK_TIMEOUT_US;
+    
+    while(rf_bringup_state == RF_BRINGUP_LOCKING) {
+        uint32_t now_us = get_system_time_us();
+        
+        // Edge missed (lock detect already high): fall back to the level
+        if(ADF_MUXOUT_PORT && (now_us - rf_lock_start_us) >= ADF7012_LD_BLANK_US) {
+            rf_lock_edge_us = now_us;
+            AMP_ENABLE_PIN = 1;
+            rf_bringup_state = RF_BRINGUP_READY;
+            break;
+        }
+        if((int32_t)(now_us - deadline_us) >= 0) {
+            rf_bringup_state = RF_BRINGUP_FAILED;
+            break;
+        }
+        cpu_idle_until_us(deadline_us);
+    }
+    
+    if(rf_bringup_state != RF_BRINGUP_READY) {
+        AMP_ENABLE_PIN = 0;
+        rf_lock_stats.timeouts++;
+        rf_status.adf7012_locked = 0;
+        return 0;
+    }
+    
+    if(rf_lock_measuring) {
+        rf_lock_record(rf_lock_edge_us - rf_lock_start_us);
+        rf_lock_measuring = 0;
+    }
+    rf_status.adf7012_locked = 1;
+    rf_status.amplifier_enabled = 1;
+    rf_status.transmission_active = 1;
+    
+    uint32_t enable_us = get_system_time_us() - rf_enable_timing.trigger_us;
+    rf_enable_timing.last_enable_us = enable_us;
+    if(enable_us > rf_enable_timing.max_enable_us) {
+        rf_enable_timing.max_enable_us = enable_us;
+    }
+    return 1;
+}
+
+// End of burst: amplifier off, LO output off, then RF output and PLL power
+// in one commit
+void rf_bringup_stop(void) {
+    rf_amplifier_enable(0);
+    rf_bringup_state = RF_BRINGUP_OFF;
+    
+    adf4351_enable_output(0);
+    adf7012_stage_register(ADF7012_REG2, adf_shadow.reg[ADF7012_REG2] & ~ADF7012_REG2_RF_ENABLE);
+    adf7012_stage_register(ADF7012_REG3, adf_shadow.reg[ADF7012_REG3] & ~ADF7012_REG3_PLL_ENABLE);
+    adf7012_commit();
+    
+    rf_status.adf7012_locked = 0;
+    rf_status.transmission_active = 0;
+}
+
+rf_bringup_state_t rf_bringup_get_state(void) {
+    return rf_bringup_state;
+}
+
+const rf_lock_stats_t* rf_get_lock_stats(void) {
+    return &rf_lock_stats;
+}
+
+const rf_enable_timing_t* rf_get_enable_timing(void) {
+    return &rf_enable_timing;
+}
+
+void rf_report_bringup_stats(void) {
+    uint32_t enable_us = rf_enable_timing.last_enable_us;
+    uint16_t avg_us = rf_lock_stats.count ? (uint16_t)(rf_lock_stats.total_us / rf_lock_stats.count) : 0;
+    
+    DEBUG_EVENT5(MSG_RF_ENABLE_TIMING, enable_us, enable_us >> 16, rf_lock_stats.max_us,
+                 adf_shadow.words_written, adf_shadow.writes_skipped);
+    DEBUG_EVENT6(MSG_RF_LOCK_STATS, rf_lock_stats.last_us, rf_lock_stats.min_us, avg_us,
+                 rf_lock_stats.max_us, rf_lock_stats.count, rf_lock_stats.timeouts);
 }
 
 // =============================================================================
@@ -268,6 +658,18 @@ void spi_select_device(spi_device_t device) {
             ADF_CS_LAT = 1;      // Deselect ADF7012
             MCP4922_CS_LAT = 0;  // Select MCP4922
             break;
+            
+        case SPI_DEVICE_ADF4351:
+            ADF_CS_LAT = 1;
+            MCP4922_CS_LAT = 1;
+            ADF4351_CS_LAT = 0;
+            break;
+            
+        case SPI_DEVICE_NONE:
+            ADF_CS_LAT = 1;
+            MCP4922_CS_LAT = 1;
+            ADF4351_CS_LAT = 1;
+            return;              // No setup time on deselect
     }
     
     __delay_us(1);  // CS setup time
@@ -297,7 +699,175 @@ uint32_t spi_transfer_32(uint32_t data) {
 void spi_write_register(spi_device_t device, uint16_t reg_data) {
     spi_select_device(device);
     spi_transfer_16(reg_data);
-    spi_select_device(SPI_DEVICE_ADF7012);  // Restore default
+    spi_select_device(SPI_DEVICE_NONE);
+}
+
+// =============================================================================
+// SPI TRANSACTION SCHEDULER
+// =============================================================================
+
+// Chip select driven directly: the 1 us setup delay of spi_select_device()
+// would take a twentieth of the chip period in the ISR, twice per chip
+static void spi_set_cs(uint8_t device, uint8_t level) {
+    switch(device) {
+        case SPI_DEVICE_ADF7012: ADF_CS_LAT = level; break;
+        case SPI_DEVICE_MCP4922: MCP4922_CS_LAT = level; break;
+        case SPI_DEVICE_ADF4351: ADF4351_CS_LAT = level; break;
+    }
+}
+
+static void spi_shift_transaction(uint8_t device, uint32_t data, uint8_t bits) {
+    spi_set_cs(device, 0);
+    if(bits == 32) {
+        spi_transfer_32(data);
+    } else {
+        spi_transfer_16((uint16_t)data);
+    }
+    spi_set_cs(device, 1);      // ADF parts latch the word on this edge
+}
+
+void spi_stream_start(void) {
+    spi_chip_head = 0;
+    spi_chip_tail = 0;
+    spi_stream_draining = 0;
+    
+    spi_sched_stats.chip_depth_min = SPI_CHIP_QUEUE_SIZE;
+    spi_sched_stats.chip_underruns = 0;
+    spi_sched_stats.bg_depth_max = 0;
+    spi_sched_stats.bg_wait_max_us = 0;
+    spi_sched_stats.bg_completed = 0;
+    spi_sched_stats.bg_stalls = 0;
+    
+    spi_stream_on = 1;
+}
+
+// Producer has queued its last chip: an empty queue is no longer an underrun
+void spi_stream_drain(void) {
+    spi_stream_draining = 1;
+}
+
+// Called with the chip timer stopped. Configuration words still queued are
+// written now, in order, before the caller touches SPI1 again
+void spi_stream_stop(void) {
+    spi_stream_on = 0;
+    
+    while(spi_bg_tail != spi_bg_head) {
+        spi_bg_transaction_t* t = &spi_bg_queue[spi_bg_tail & (SPI_BG_QUEUE_SIZE - 1)];
+        spi_shift_transaction(t->device, t->data, t->bits);
+        spi_bg_tail++;
+        spi_sched_stats.bg_completed++;
+    }
+    
+    spi_chip_head = 0;
+    spi_chip_tail = 0;
+}
+
+uint8_t spi_stream_active(void) {
+    return spi_stream_on;
+}
+
+// Drain under way with chips still to shift out
+uint8_t spi_stream_draining_chips(void) {
+    return spi_stream_draining && spi_chip_head != spi_chip_tail;
+}
+
+uint8_t spi_queue_chip(uint16_t i_cmd, uint16_t q_cmd) {
+    uint16_t head = spi_chip_head;
+    
+    if((uint16_t)(head - spi_chip_tail) >= SPI_CHIP_QUEUE_SIZE) {
+        return 0;
+    }
+    
+    frame_arena.shared.tx.chip_queue[head & (SPI_CHIP_QUEUE_SIZE - 1)][0] = i_cmd;
+    frame_arena.shared.tx.chip_queue[head & (SPI_CHIP_QUEUE_SIZE - 1)][1] = q_cmd;
+    spi_chip_head = head + 1;
+    return 1;
+}
+
+uint16_t spi_chip_queue_depth(void) {
+    return spi_chip_head - spi_chip_tail;
+}
+
+// Configuration write. Outside a burst it goes out at once; during a burst
+// it waits in the background queue for a chip gap. A full queue stalls the
+// caller for at most a few chip periods rather than losing the word
+void spi_submit_background(spi_device_t device, uint32_t data, uint8_t bits) {
+    uint16_t depth;
+    
+    if(!spi_stream_on) {
+        spi_shift_transaction(device, data, bits);
+        return;
+    }
+    
+    if((uint16_t)(spi_bg_head - spi_bg_tail) >= SPI_BG_QUEUE_SIZE) {
+        spi_sched_stats.bg_stalls++;
+        while((uint16_t)(spi_bg_head - spi_bg_tail) >= SPI_BG_QUEUE_SIZE && spi_stream_on) {
+            Idle();
+        }
+        if(!spi_stream_on) {
+            spi_shift_transaction(device, data, bits);
+            return;
+        }
+    }
+    
+    spi_bg_transaction_t* t = &spi_bg_queue[spi_bg_head & (SPI_BG_QUEUE_SIZE - 1)];
+    t->device = device;
+    t->bits = bits;
+    t->data = data;
+    t->queued_us = SYSTEM_TIME_US16();
+    spi_bg_head++;
+    
+    depth = spi_bg_head - spi_bg_tail;
+    if(depth > spi_sched_stats.bg_depth_max) {
+        spi_sched_stats.bg_depth_max = depth;
+    }
+}
+
+// CCP1 ISR, once per chip: the chip pair first so the DAC update keeps a
+// fixed latency from the tick, then one configuration word if any is waiting
+void spi_service_chip_tick(void) {
+    if(!spi_stream_on) return;
+    
+    uint16_t tail = spi_chip_tail;
+    uint16_t depth = spi_chip_head - tail;
+    
+    if(depth) {
+        uint16_t* chip = frame_arena.shared.tx.chip_queue[tail & (SPI_CHIP_QUEUE_SIZE - 1)];
+        spi_shift_transaction(SPI_DEVICE_MCP4922, chip[0], 16);
+        spi_shift_transaction(SPI_DEVICE_MCP4922, chip[1], 16);
+        spi_chip_tail = tail + 1;
+    }
+    
+    if(!spi_stream_draining) {
+        if(depth == 0) {
+            spi_sched_stats.chip_underruns++;
+        } else if(depth - 1 < spi_sched_stats.chip_depth_min) {
+            spi_sched_stats.chip_depth_min = depth - 1;
+        }
+    }
+    
+    if(spi_bg_tail != spi_bg_head) {
+        spi_bg_transaction_t* t = &spi_bg_queue[spi_bg_tail & (SPI_BG_QUEUE_SIZE - 1)];
+        uint16_t wait_us = SYSTEM_TIME_US16() - t->queued_us;
+        
+        spi_shift_transaction(t->device, t->data, t->bits);
+        spi_bg_tail++;
+        spi_sched_stats.bg_completed++;
+        if(wait_us > spi_sched_stats.bg_wait_max_us) {
+            spi_sched_stats.bg_wait_max_us = wait_us;
+        }
+    }
+}
+
+const spi_sched_stats_t* spi_get_sched_stats(void) {
+    return &spi_sched_stats;
+}
+
+void spi_report_sched_stats(void) {
+    DEBUG_EVENT6(MSG_SPI_QUEUE_STATS, spi_sched_stats.chip_depth_min,
+                 spi_sched_stats.chip_underruns, spi_sched_stats.bg_depth_max,
+                 spi_sched_stats.bg_wait_max_us, spi_sched_stats.bg_completed,
+                 spi_sched_stats.bg_stalls);
 }
 
 // =============================================================================
@@ -362,6 +932,14 @@ void rf_perform_calibration(void) {
     DEBUG_LOG_FLUSH("RF calibration completed\r\n");
 }
 
+// Restore a calibration saved by an earlier boot
+void rf_calibration_load(const rf_calibration_t* calibration) {
+    rf_calibration = *calibration;
+    rf_calibration.calibrated = 1;
+    
+    DEBUG_LOG_FLUSH("RF calibration restored\r\n");
+}
+
 rf_calibration_t* rf_get_calibration(void) {
     return &rf_calibration;
 }
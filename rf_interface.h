@@ -24,6 +24,7 @@ void mcp4922_init(void);
 void mcp4922_write_dac_a(uint16_t value);
 void mcp4922_write_dac_b(uint16_t value);
 void mcp4922_write_both(uint16_t i_value, uint16_t q_value);
+void mcp4922_command_words(uint16_t i_value, uint16_t q_value, uint16_t* i_cmd, uint16_t* q_cmd);
 void mcp4922_shutdown(void);
 void mcp4922_test_output(void);
 
@@ -37,15 +38,148 @@ void mcp4922_test_output(void);
 #define ADF7012_REG2    0x02    // Function control
 #define ADF7012_REG3    0x03    // Initialization
 
+#define ADF7012_NUM_REGS 4
+
 // ADF7012 configuration for 406 MHz
 #define ADF7012_FREQ_406MHZ     406025000UL
 
+// Power-up register values (REG1 comes from the channel table)
+#define ADF7012_REG0_INIT       0x200000UL      // Reference setup
+#define ADF7012_REG2_INIT       0x10E42AUL      // Function control
+#define ADF7012_REG3_INIT       0x0001C7UL      // Initialize
+#define ADF7012_REG2_RF_ENABLE  0x000008UL      // RF output enable
+#define ADF7012_REG3_PLL_ENABLE 0x000004UL      // PLL (synthesizer) power
+
+// MUXOUT (REG3 DB21:DB18) set to digital lock detect, read on RB0
+#define ADF7012_REG3_MUXOUT_MASK    (0xFUL << 18)
+#define ADF7012_REG3_MUXOUT_LD      (0x3UL << 18)
+
+#define ADF7012_POWER_ON_US     10000UL     // Supply settling, counted from reset
+#define ADF7012_LOCK_TIMEOUT_US 5000UL      // Former fixed worst-case delay
+
+// Register shadow: the last value latched into each register. Writes are
+// staged against it and only registers that changed are shifted out, in
+// one CS-framed sequence per commit
+typedef struct {
+    uint32_t reg[ADF7012_NUM_REGS];
+    uint8_t dirty;              // Bit n: reg[n] staged but not yet written
+    uint8_t valid;              // Bit n: reg[n] holds what the device holds
+    uint16_t words_written;     // Register words shifted out
+    uint16_t writes_skipped;    // Staged values equal to the shadow
+} adf7012_shadow_t;
+
 // ADF7012 functions
 void adf7012_init(void);
 void adf7012_set_frequency(uint32_t frequency);
 void adf7012_enable_output(uint8_t enable);
 void adf7012_write_register(uint8_t reg, uint32_t data);
+void adf7012_stage_register(uint8_t reg, uint32_t data);
+uint8_t adf7012_commit(void);
+uint8_t adf7012_wait_lock(uint32_t timeout_us);
 uint8_t adf7012_get_lock_status(void);
+const adf7012_shadow_t* adf7012_get_shadow(void);
+
+// =============================================================================
+// ADF4351 LO SYNTHESIZER INTERFACE
+// =============================================================================
+
+#define ADF4351_NUM_REGS        6
+
+// Fixed register fields (REG0 carries INT/FRAC and comes from the channel plan)
+#define ADF4351_PRESCALER_89    (1UL << 27)     // REG1: 8/9 prescaler (INT >= 75)
+#define ADF4351_PHASE_1         (1UL << 15)     // REG1: recommended phase word
+#define ADF4351_MUXOUT_DLD      (6UL << 26)     // REG2: digital lock detect
+#define ADF4351_CP_2_5MA        (7UL << 9)      // REG2: charge pump current
+#define ADF4351_PD_POSITIVE     (1UL << 6)      // REG2: phase detector polarity
+#define ADF4351_CLK_DIV_150     (150UL << 3)    // REG3: clock divider value
+#define ADF4351_FB_FUNDAMENTAL  (1UL << 23)     // REG4: feedback from the VCO
+#define ADF4351_BS_CLK_DIV      (200UL << 12)   // REG4: band select clock <= 125 kHz
+#define ADF4351_RF_OUT_ENABLE   (1UL << 5)      // REG4
+#define ADF4351_RF_POWER_5DBM   (3UL << 3)      // REG4
+#define ADF4351_LD_PIN_DLD      (1UL << 22)     // REG5: LD pin = digital lock detect
+#define ADF4351_REG5_RESERVED   (3UL << 19)     // REG5: must be set
+
+void adf4351_init(void);
+void adf4351_write_register(uint8_t reg, uint32_t data);
+void adf4351_enable_output(uint8_t enable);
+
+// =============================================================================
+// SYNTHESIZER CHANNEL PLAN
+// =============================================================================
+
+// Both synthesizers run from the 25 MHz reference and every channel sits on
+// a 25 kHz raster. Each register field below is an integer constant
+// expression, so the compiler plans the whole table and a retune is a table
+// lookup plus one SPI burst per part
+#define SYNTH_REFIN_HZ          25000000UL
+#define SYNTH_RASTER_HZ         25000UL
+
+// ADF4351: RFout = fPFD x (INT + FRAC/MOD) / RFdiv. fPFD = 25 MHz (R = 1),
+// divide-by-8 output puts the VCO at 3.2 GHz (2.2-4.4 GHz range). MOD is
+// chosen so that the 25 kHz raster is a whole number of FRAC steps
+// (3.125 kHz at the output): every channel is exact
+#define ADF4351_R_COUNTER       1UL
+#define ADF4351_PFD_HZ          (SYNTH_REFIN_HZ / ADF4351_R_COUNTER)
+#define ADF4351_RF_DIV_SEL      3UL             // REG4: divide by 2^3
+#define ADF4351_RF_DIV          (1UL << ADF4351_RF_DIV_SEL)
+#define ADF4351_MOD             1000UL
+
+#define ADF4351_VCO_HZ(f)       ((uint64_t)(f) * ADF4351_RF_DIV)
+#define ADF4351_INT(f)          (ADF4351_VCO_HZ(f) / ADF4351_PFD_HZ)
+#define ADF4351_FRAC(f)         ((ADF4351_VCO_HZ(f) % ADF4351_PFD_HZ) * ADF4351_MOD / ADF4351_PFD_HZ)
+#define ADF4351_REG0_FOR(f)     ((uint32_t)((ADF4351_INT(f) << 15) | (ADF4351_FRAC(f) << 3)))
+
+// ADF7012: RFout = fPFD x (INT + FRAC/4096), the modulus is fixed. fPFD =
+// 12.5 MHz (R = 2), 4/5 prescaler. FRAC is rounded to the nearest 3.05 kHz
+// step; the residual is kept in the table
+#define ADF7012_R_COUNTER       2UL
+#define ADF7012_REG0_R_SHIFT    2               // REG0 DB5:DB2
+#define ADF7012_REG0_R_MASK     (0xFUL << ADF7012_REG0_R_SHIFT)
+#define ADF7012_PFD_HZ          (SYNTH_REFIN_HZ / ADF7012_R_COUNTER)
+
+#define ADF7012_N_X4096(f)      ((((uint64_t)(f) << 12) + ADF7012_PFD_HZ / 2) / ADF7012_PFD_HZ)
+#define ADF7012_INT(f)          (ADF7012_N_X4096(f) >> 12)
+#define ADF7012_FRAC(f)         (ADF7012_N_X4096(f) & 0xFFF)
+#define ADF7012_REG1_FOR(f)     ((uint32_t)((ADF7012_INT(f) << 14) | (ADF7012_FRAC(f) << 2)))
+#define ADF7012_ERROR_HZ(f)     ((int16_t)((int64_t)(f) - \
+                                 (int64_t)((ADF7012_N_X4096(f) * ADF7012_PFD_HZ + 2048) >> 12)))
+
+#define SYNTH_CHANNEL(f)        { (f), ADF7012_REG1_FOR(f), ADF4351_REG0_FOR(f), ADF7012_ERROR_HZ(f) }
+
+// Channel check on the packed register words, also a constant expression:
+// the ADF4351 INT/FRAC decode gives exactly f (INT >= 75, FRAC < MOD) and
+// the ADF7012 N is within half a FRAC step (PFD / 8192) of f
+#define SYNTH_LO_INT(f)         ((uint64_t)(ADF4351_REG0_FOR(f) >> 15))
+#define SYNTH_LO_FRAC(f)        ((uint64_t)((ADF4351_REG0_FOR(f) >> 3) & 0xFFF))
+#define SYNTH_TX_ERROR_X4096(f) ((int64_t)((uint64_t)(f) << 12) - \
+                                 (int64_t)(((ADF7012_REG1_FOR(f) >> 2) & 0xFFFFFUL) * (uint64_t)ADF7012_PFD_HZ))
+#define SYNTH_CHANNEL_VALID(f)  ((uint64_t)(f) * ADF4351_RF_DIV * ADF4351_MOD == \
+                                     (SYNTH_LO_INT(f) * ADF4351_MOD + SYNTH_LO_FRAC(f)) * ADF4351_PFD_HZ && \
+                                 SYNTH_LO_INT(f) >= 75 && SYNTH_LO_FRAC(f) < ADF4351_MOD && \
+                                 SYNTH_TX_ERROR_X4096(f) <= (int64_t)ADF7012_PFD_HZ / 2 && \
+                                 SYNTH_TX_ERROR_X4096(f) >= -(int64_t)ADF7012_PFD_HZ / 2)
+
+typedef struct {
+    uint32_t frequency_hz;
+    uint32_t adf7012_reg1;      // N register (INT/FRAC)
+    uint32_t adf4351_reg0;      // INT/FRAC register
+    int16_t adf7012_error_hz;   // Residual of the fixed 4096 modulus
+} synth_channel_t;
+
+// Exercise channel plan. 406.025 MHz is for conducted tests into a dummy
+// load only (never radiated, see README)
+typedef enum {
+    SYNTH_CH_403_000 = 0,
+    SYNTH_CH_403_025,
+    SYNTH_CH_403_050,
+    SYNTH_CH_406_025,
+    SYNTH_NUM_CHANNELS
+} synth_channel_id_t;
+
+#define SYNTH_DEFAULT_CHANNEL   SYNTH_CH_406_025
+
+void synth_set_channel(synth_channel_id_t channel);
+const synth_channel_t* synth_get_channel(synth_channel_id_t channel);
 
 // =============================================================================
 // RF POWER CONTROL
@@ -63,16 +197,62 @@ typedef enum {
 void rf_amplifier_enable(uint8_t enable);
 void rf_power_level_set(uint8_t level);
 void rf_set_power_level(rf_power_level_t level);
-void rf_enable_carrier(uint8_t enable);
+uint8_t rf_enable_carrier(uint8_t enable);
+
+// =============================================================================
+// RF BRING-UP
+// =============================================================================
+
+// Burst RF bring-up. rf_bringup_start() runs at the burst trigger: it powers
+// the PLL and returns, so the synthesizer settles while the frame is built.
+// The lock-detect rising edge (RB0 interrupt-on-change) switches on the
+// amplifier, and rf_bringup_wait_ready() only waits for what is left
+// before the first chip
+typedef enum {
+    RF_BRINGUP_OFF = 0,         // PLL powered down, amplifier off
+    RF_BRINGUP_LOCKING,         // PLL powered, waiting for lock detect
+    RF_BRINGUP_READY,           // Locked, amplifier on
+    RF_BRINGUP_FAILED           // No lock within ADF7012_LOCK_TIMEOUT_US
+} rf_bringup_state_t;
+
+#define RF_LOCK_ISR_IPL         4       // Below the chip clock (5)
+
+// Lock times, PLL power-up (or retune) to lock detect
+typedef struct {
+    uint16_t count;
+    uint16_t last_us;
+    uint16_t min_us;
+    uint16_t max_us;
+    uint32_t total_us;
+    uint16_t timeouts;
+} rf_lock_stats_t;
+
+// Burst trigger to RF output (amplifier on, ready for the first chip)
+typedef struct {
+    uint32_t trigger_us;        // rf_bringup_start() time of the current burst
+    uint32_t last_enable_us;
+    uint32_t max_enable_us;
+} rf_enable_timing_t;
+
+void rf_bringup_start(void);
+uint8_t rf_bringup_wait_ready(void);
+void rf_bringup_stop(void);
+rf_bringup_state_t rf_bringup_get_state(void);
+const rf_lock_stats_t* rf_get_lock_stats(void);
+const rf_enable_timing_t* rf_get_enable_timing(void);
+void rf_report_bringup_stats(void);
 
 // =============================================================================
 // SPI INTERFACE (shared between MCP4922 and ADF7012)
 // =============================================================================
 
-// SPI device selection
+// SPI device selection. The ADF7012 latches a register on the rising edge of
+// its CS (LE), so the bus idles with nothing selected
 typedef enum {
     SPI_DEVICE_ADF7012 = 0,
-    SPI_DEVICE_MCP4922
+    SPI_DEVICE_MCP4922,
+    SPI_DEVICE_ADF4351,
+    SPI_DEVICE_NONE
 } spi_device_t;
 
 // SPI functions
@@ -81,6 +261,44 @@ uint16_t spi_transfer_16(uint16_t data);
 uint32_t spi_transfer_32(uint32_t data);
 void spi_write_register(spi_device_t device, uint16_t reg_data);
 
+// =============================================================================
+// SPI TRANSACTION SCHEDULER
+// =============================================================================
+
+// While a burst is on air the CCP1 ISR owns SPI1. On every chip tick it
+// writes the next queued I/Q pair (hard real-time class), then at most one
+// queued configuration word (background class) in the gap before the next
+// chip. Outside bursts background words are written at once by the caller
+#define SPI_BG_QUEUE_SIZE       8       // Configuration words (power of 2)
+
+typedef struct {
+    uint8_t device;             // spi_device_t
+    uint8_t bits;               // 16 or 32
+    uint32_t data;
+    uint16_t queued_us;         // SYSTEM_TIME_US16() at enqueue
+} spi_bg_transaction_t;
+
+typedef struct {
+    uint16_t chip_depth_min;    // Lowest chip queue fill seen at a tick
+    uint16_t chip_underruns;    // Ticks that found the chip queue empty
+    uint16_t bg_depth_max;      // Deepest background queue
+    uint16_t bg_wait_max_us;    // Longest enqueue to shift-out wait
+    uint16_t bg_completed;
+    uint16_t bg_stalls;         // Submits that waited for a free slot
+} spi_sched_stats_t;
+
+void spi_stream_start(void);
+void spi_stream_drain(void);
+void spi_stream_stop(void);
+uint8_t spi_stream_active(void);
+uint8_t spi_stream_draining_chips(void);
+uint8_t spi_queue_chip(uint16_t i_cmd, uint16_t q_cmd);
+uint16_t spi_chip_queue_depth(void);
+void spi_submit_background(spi_device_t device, uint32_t data, uint8_t bits);
+void spi_service_chip_tick(void);
+const spi_sched_stats_t* spi_get_sched_stats(void);
+void spi_report_sched_stats(void);
+
 // =============================================================================
 // I/Q MODULATION HELPERS
 // =============================================================================
@@ -111,6 +329,7 @@ typedef struct {
 // Calibration functions
 void rf_calibration_init(void);
 void rf_perform_calibration(void);
+void rf_calibration_load(const rf_calibration_t* calibration);
 rf_calibration_t* rf_get_calibration(void);
 void rf_apply_calibration(uint16_t* i_value, uint16_t* q_value);
 
@@ -15,15 +15,15 @@
 
 // Communication states
 tx_state_t tx_state_2g = {IDLE_STATE, 0, 0, 0, 0};
-oqpsk_state_t oqpsk_state_2g = {0, 0, 0, {0}, 0};
+oqpsk_state_t oqpsk_state_2g = {0, 0, 0, frame_arena.shared.tx.frame_bits, 0, 0};
 prn_state_t prn_state_2g = {0, 0, 0x12345, 0x54321, 0};
 
 // GPS data storage
 static gps_data_t current_gps_data = {0};
 gps_data_t test_position_2g = {
-    .latitude = 45.1885,      // Grenoble latitude
-    .longitude = 5.7245,      // Grenoble longitude  
-    .altitude = 214.0,        // Grenoble altitude (m)
+    .latitude_e7 = 451885000,     // Grenoble latitude
+    .longitude_e7 = 57245000,     // Grenoble longitude
+    .altitude_cm = 21400,         // Grenoble altitude (214 m)
     .satellites = 8,          // Good fix
     .fix_quality = 1,         // GPS fix
     .valid = 1,               // Valid data
@@ -31,13 +31,39 @@ gps_data_t test_position_2g = {
     .day = 15, .month = 11, .year = 2024
 };
 
-// NMEA buffer
+// NMEA sentence buffer (only the configured protocol's parser owns RAM)
+#if GPS_PROTOCOL == GPS_PROTOCOL_NMEA
 static char nmea_buffer[NMEA_BUFFER_SIZE];
 static uint8_t nmea_index = 0;
+#endif
+
+// TSIP packet decoder state
+typedef enum {
+    TSIP_WAIT_DLE = 0,      // Between packets
+    TSIP_WAIT_ID,           // DLE seen, packet ID next
+    TSIP_DATA,              // Collecting data bytes
+    TSIP_DATA_DLE           // DLE inside packet: stuffed DLE or end of packet
+} tsip_rx_state_t;
+
+#if GPS_PROTOCOL == GPS_PROTOCOL_TSIP
+static uint8_t tsip_buffer[TSIP_BUFFER_SIZE];
+static tsip_rx_state_t tsip_state = TSIP_WAIT_DLE;
+static uint8_t tsip_id = 0;
+static uint8_t tsip_length = 0;
+#endif
+
+// UART2 RX ring - single producer (_U2RXInterrupt), single consumer
+// (gps_update). Head is only written by the ISR, tail only by the main loop,
+// and both are 16-bit so every access is atomic without masking interrupts
+static volatile uint8_t gps_rx_buffer[GPS_RX_BUFFER_SIZE];
+static volatile uint16_t gps_rx_head = 0;
+static volatile uint16_t gps_rx_tail = 0;
+static volatile gps_rx_stats_t gps_rx_stats = {0, 0, 0};
+
+#define GPS_RX_MASK     (GPS_RX_BUFFER_SIZE - 1)
 
 // Timing
 uint32_t tx_interval_ms = 10000;  // Default 10 seconds
-extern volatile uint32_t millis_counter;
 
 // =============================================================================
 // GPS MANAGER (Trimble 63530-00)
@@ -45,41 +71,283 @@ extern volatile uint32_t millis_counter;
 
 void gps_init(void) {
     memset(&current_gps_data, 0, sizeof(gps_data_t));
+    #if GPS_PROTOCOL == GPS_PROTOCOL_NMEA
     memset(nmea_buffer, 0, NMEA_BUFFER_SIZE);
     nmea_index = 0;
+    #else
+    tsip_state = TSIP_WAIT_DLE;
+    #endif
     
     DEBUG_LOG_FLUSH("GPS Manager initialized for Trimble 63530-00\r\n");
 }
 
-uint8_t gps_update(void) {
-    // Check if UART2 has received data
+// UART2 RX interrupt - move bytes from the hardware FIFO into the ring
+void __attribute__((__interrupt__, __auto_psv__)) _U2RXInterrupt(void) {
+    ISR_ENTER(ISR_ID_U2RX);
+    uint16_t head = gps_rx_head;
+    
     while(!U2STAHbits.URXBE) {
-        char c = U2RXREG;
+        uint8_t c = U2RXREG;
+        uint16_t next = (head + 1) & GPS_RX_MASK;
+        
+        if(next != gps_rx_tail) {
+            gps_rx_buffer[head] = c;
+            head = next;
+        } else {
+            gps_rx_stats.ring_overruns++;   // Ring full: drop newest byte
+        }
+    }
+    gps_rx_head = head;
+    
+    // Hardware overrun stops reception until cleared
+    if(U2STAbits.OERR) {
+        U2STAbits.OERR = 0;
+        gps_rx_stats.hw_overruns++;
+    }
+    
+    IFS1bits.U2RXIF = 0;
+    ISR_EXIT();
+}
+
+uint8_t gps_update(void) {
+    uint8_t new_data = 0;
+    uint16_t tail = gps_rx_tail;
+    uint16_t head = gps_rx_head;
+    
+    uint16_t used = (head - tail) & GPS_RX_MASK;
+    if(used > gps_rx_stats.high_water) {
+        gps_rx_stats.high_water = used;
+    }
+    
+    // Assemble and parse every complete sentence/packet received so far
+    while(tail != head) {
+        uint8_t c = gps_rx_buffer[tail];
+        tail = (tail + 1) & GPS_RX_MASK;
         
-        // Handle NMEA sentence building
-        if(c == '$') {
+        #if GPS_PROTOCOL == GPS_PROTOCOL_TSIP
+        new_data |= tsip_process_byte(c);
+        #else
+        new_data |= nmea_process_byte((char)c);
+        #endif
+    }
+    gps_rx_tail = tail;
+    
+    return new_data;
+}
+
+// NMEA sentence building - returns 1 when a sentence updated the fix
+uint8_t nmea_process_byte(char c) {
+    uint8_t new_data = 0;
+    
+    #if GPS_PROTOCOL == GPS_PROTOCOL_NMEA
+    if(c == '$') {
+        nmea_index = 0;
+        nmea_buffer[nmea_index++] = c;
+    }
+    else if(c == '\r' || c == '\n') {
+        if(nmea_index > 0) {
+            nmea_buffer[nmea_index] = '\0';
+            new_data = parse_nmea_sentence(nmea_buffer);
             nmea_index = 0;
-            nmea_buffer[nmea_index++] = c;
         }
-        else if(c == '\r' || c == '\n') {
-            if(nmea_index > 0) {
-                nmea_buffer[nmea_index] = '\0';
-                
-                if(parse_nmea_sentence(nmea_buffer)) {
-                    return 1;  // New data available
+    }
+    else if(nmea_index < (NMEA_BUFFER_SIZE - 1)) {
+        nmea_buffer[nmea_index++] = c;
+    }
+    else {
+        nmea_index = 0;  // Buffer overflow
+    }
+    #else
+    (void)c;
+    #endif
+    
+    return new_data;
+}
+
+// TSIP packet framing (DLE stuffing) - returns 1 when a packet updated the fix
+uint8_t tsip_process_byte(uint8_t c) {
+    #if GPS_PROTOCOL == GPS_PROTOCOL_TSIP
+    switch(tsip_state) {
+        case TSIP_WAIT_DLE:
+            if(c == TSIP_DLE) {
+                tsip_state = TSIP_WAIT_ID;
+            }
+            break;
+            
+        case TSIP_WAIT_ID:
+            if(c == TSIP_DLE || c == TSIP_ETX) {
+                tsip_state = TSIP_WAIT_DLE;     // Not a packet start
+            } else {
+                tsip_id = c;
+                tsip_length = 0;
+                tsip_state = TSIP_DATA;
+            }
+            break;
+            
+        case TSIP_DATA:
+            if(c == TSIP_DLE) {
+                tsip_state = TSIP_DATA_DLE;
+            } else if(tsip_length < TSIP_BUFFER_SIZE) {
+                tsip_buffer[tsip_length++] = c;
+            } else {
+                tsip_state = TSIP_WAIT_DLE;     // Oversized packet, drop
+            }
+            break;
+            
+        case TSIP_DATA_DLE:
+            if(c == TSIP_DLE) {
+                // Stuffed DLE data byte
+                if(tsip_length < TSIP_BUFFER_SIZE) {
+                    tsip_buffer[tsip_length++] = c;
+                    tsip_state = TSIP_DATA;
+                } else {
+                    tsip_state = TSIP_WAIT_DLE;
                 }
-                nmea_index = 0;
+            } else if(c == TSIP_ETX) {
+                tsip_state = TSIP_WAIT_DLE;
+                return parse_tsip_packet(tsip_id, tsip_buffer, tsip_length);
+            } else {
+                // Lost an ETX: treat as the start of a new packet
+                tsip_id = c;
+                tsip_length = 0;
+                tsip_state = TSIP_DATA;
             }
+            break;
+    }
+    #endif
+    
+    return 0;
+}
+
+// Big-endian field readers (TSIP byte order)
+static uint16_t tsip_u16(const uint8_t* p) {
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static uint32_t tsip_u32(const uint8_t* p) {
+    return ((uint32_t)tsip_u16(p) << 16) | tsip_u16(p + 2);
+}
+
+uint8_t parse_tsip_packet(uint8_t id, const uint8_t* data, uint8_t len) {
+    if(id != TSIP_ID_SUPER || len < 1) {
+        return 0;
+    }
+    
+    switch(data[0]) {
+        case TSIP_SUB_FIX_EXTRA:
+            return parse_tsip_fix(data, len);
+        case TSIP_SUB_TIMING:
+            return parse_tsip_timing(data, len);
+        default:
+            return 0;
+    }
+}
+
+// 0x8F-20: position in 2^-31 semicircles and altitude in mm - integer only.
+// 1e-7 deg = sc * 180e7 / 2^31 (lat |sc| <= 2^30, lon wraps to +/-2^31)
+uint8_t parse_tsip_fix(const uint8_t* data, uint8_t len) {
+    if(len < 32) {
+        return 0;
+    }
+    
+    current_gps_data.satellites = data[28];
+    
+    // Fix flags bit 0: no fix available
+    if(data[27] & 0x01) {
+        current_gps_data.fix_quality = 0;
+        current_gps_data.valid = 0;
+        return 0;
+    }
+    
+    int32_t lat_sc = (int32_t)tsip_u32(&data[12]);
+    int32_t lon_sc = (int32_t)tsip_u32(&data[16]);     // 0..360 deg -> +/-180
+    int32_t alt_mm = (int32_t)tsip_u32(&data[20]);     // Above WGS-84 ellipsoid
+    
+    current_gps_data.latitude_e7 = (int32_t)(((int64_t)lat_sc * 1800000000LL + (1LL << 30)) >> 31);
+    current_gps_data.longitude_e7 = (int32_t)(((int64_t)lon_sc * 1800000000LL + (1LL << 30)) >> 31);
+    current_gps_data.altitude_cm = alt_mm / 10 - TSIP_GEOID_SEPARATION_CM;   // Ellipsoid -> MSL
+    current_gps_data.fix_quality = (data[27] & 0x02) ? 2 : 1;    // Bit 1: DGPS
+    
+    current_gps_data.valid = 1;
+    return 1;
+}
+
+static uint8_t tsip_days_in_month(uint8_t month, uint16_t year) {
+    static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if(month == 2 && (year & 3) == 0) {
+        return 29;      // 2000-2099: every fourth year
+    }
+    return days[(month - 1) % 12];
+}
+
+// 0x8F-AB: time of week, week, UTC offset (bytes 1-8), timing flags (9),
+// then seconds, minutes, hours, day, month, year (bytes 10-16). The
+// date/time is GPS time unless flag bit 0 is set; GPS time is moved to UTC
+// with the offset, and a report without a usable offset is dropped
+uint8_t parse_tsip_timing(const uint8_t* data, uint8_t len) {
+    if(len < 17) {
+        return 0;
+    }
+    
+    uint8_t flags = data[9];
+    if(flags & TSIP_TIMING_NOT_SET) {
+        return 0;
+    }
+    
+    int32_t utc_offset = 0;
+    if(!(flags & TSIP_TIMING_UTC)) {
+        if(flags & TSIP_TIMING_NO_UTC) {
+            return 0;   // GPS time, leap seconds unknown
         }
-        else if(nmea_index < (NMEA_BUFFER_SIZE - 1)) {
-            nmea_buffer[nmea_index++] = c;
+        utc_offset = (int16_t)tsip_u16(&data[7]);
+    }
+    
+    uint8_t day = data[13];
+    uint8_t month = data[14];
+    uint16_t year = tsip_u16(&data[15]);
+    if(month < 1 || month > 12 || day < 1) {
+        return 0;
+    }
+    
+    // UTC = GPS - offset; the offset is seconds, so at most one day boundary
+    int32_t tod = (int32_t)data[12] * 3600L + data[11] * 60 + data[10] - utc_offset;
+    if(tod < 0) {
+        tod += 86400L;
+        if(--day == 0) {
+            if(--month == 0) {
+                month = 12;
+                year--;
+            }
+            day = tsip_days_in_month(month, year);
         }
-        else {
-            nmea_index = 0;  // Buffer overflow
+    } else if(tod >= 86400L) {
+        tod -= 86400L;
+        if(++day > tsip_days_in_month(month, year)) {
+            day = 1;
+            if(++month > 12) {
+                month = 1;
+                year++;
+            }
         }
     }
     
-    return 0;
+    current_gps_data.hour   = (uint8_t)(tod / 3600);
+    current_gps_data.minute = (uint8_t)((tod / 60) % 60);
+    current_gps_data.second = (uint8_t)(tod % 60);
+    current_gps_data.day    = day;
+    current_gps_data.month  = month;
+    current_gps_data.year   = year;
+    
+    return 0;   // Time only, the fix itself comes from 0x8F-20
+}
+
+gps_rx_stats_t* gps_get_rx_stats(void) {
+    return (gps_rx_stats_t*)&gps_rx_stats;
+}
+
+void gps_report_rx_stats(void) {
+    DEBUG_EVENT4(MSG_GPS_RX_STATS, gps_rx_stats.ring_overruns, gps_rx_stats.hw_overruns,
+                 gps_rx_stats.high_water, GPS_RX_BUFFER_SIZE - 1);
 }
 
 gps_data_t* get_current_gps_data(void) {
@@ -94,41 +362,186 @@ gps_data_t* get_test_position(void) {
     return &test_position_2g;
 }
 
-uint8_t parse_nmea_sentence(const char* sentence) {
-    if(sentence == NULL || strlen(sentence) < 6) {
+uint8_t parse_nmea_sentence(char* sentence) {
+    char* fields[NMEA_MAX_FIELDS];
+    
+    // Single pass: split fields in place and verify the *hh checksum
+    uint8_t num_fields = nmea_tokenize(sentence, fields, NMEA_MAX_FIELDS);
+    if(num_fields == 0 || strlen(fields[0]) != 6) {
         return 0;
     }
     
-    if(strncmp(sentence, "$GPGGA", 6) == 0) {
-        return parse_gga(sentence);
+    // Any talker ($GPxxx, $GNxxx, ...)
+    const char* type = fields[0] + 3;
+    
+    if(strcmp(type, "GGA") == 0) {
+        return parse_gga(fields, num_fields);
     }
     
-    if(strncmp(sentence, "$GPRMC", 6) == 0) {
-        return parse_rmc(sentence);
+    if(strcmp(type, "RMC") == 0) {
+        return parse_rmc(fields, num_fields);
     }
     
     return 0;
 }
 
-uint8_t parse_gga(const char* sentence) {
-    // Simplified parsing - use test data until real GPS connected
-    if(get_beacon_mode_2g() == MODE_EXERCISE) {
-        memcpy(&current_gps_data, &test_position_2g, sizeof(gps_data_t));
-        current_gps_data.valid = 1;
-        return 1;
+// $xxGGA,hhmmss.ss,ddmm.mmmm,N,dddmm.mmmm,E,q,ss,h.h,alt,M,...
+uint8_t parse_gga(char** fields, uint8_t num_fields) {
+    if(num_fields < 10) {
+        return 0;
     }
     
-    return 0;
+    uint8_t quality = (uint8_t)(nmea_to_centi(fields[6]) / 100);
+    current_gps_data.fix_quality = quality;
+    current_gps_data.satellites = (uint8_t)(nmea_to_centi(fields[7]) / 100);
+    
+    const char* t = fields[1];
+    if(quality == 0 || strlen(t) < 6 || fields[2][0] == '\0' || fields[4][0] == '\0') {
+        current_gps_data.valid = 0;
+        return 0;
+    }
+    
+    current_gps_data.hour   = (t[0] - '0') * 10 + (t[1] - '0');
+    current_gps_data.minute = (t[2] - '0') * 10 + (t[3] - '0');
+    current_gps_data.second = (t[4] - '0') * 10 + (t[5] - '0');
+    
+    current_gps_data.latitude_e7 = nmea_to_degrees_e7(fields[2], fields[3][0]);
+    current_gps_data.longitude_e7 = nmea_to_degrees_e7(fields[4], fields[5][0]);
+    current_gps_data.altitude_cm = nmea_to_centi(fields[9]);
+    
+    current_gps_data.valid = 1;
+    return 1;
 }
 
-uint8_t parse_rmc(const char* sentence) {
-    // Simplified implementation
-    return 0;
+// $xxRMC,hhmmss.ss,A,ddmm.mmmm,N,dddmm.mmmm,E,spd,crs,ddmmyy,...
+uint8_t parse_rmc(char** fields, uint8_t num_fields) {
+    if(num_fields < 10 || fields[2][0] != 'A') {
+        return 0;  // Short sentence or receiver warning (V)
+    }
+    
+    const char* t = fields[1];
+    const char* d = fields[9];
+    if(strlen(t) < 6 || strlen(d) != 6) {
+        return 0;
+    }
+    
+    current_gps_data.hour   = (t[0] - '0') * 10 + (t[1] - '0');
+    current_gps_data.minute = (t[2] - '0') * 10 + (t[3] - '0');
+    current_gps_data.second = (t[4] - '0') * 10 + (t[5] - '0');
+    current_gps_data.day    = (d[0] - '0') * 10 + (d[1] - '0');
+    current_gps_data.month  = (d[2] - '0') * 10 + (d[3] - '0');
+    current_gps_data.year   = 2000 + (d[4] - '0') * 10 + (d[5] - '0');
+    
+    // Same fix epoch as GGA; altitude only comes from GGA
+    current_gps_data.latitude_e7 = nmea_to_degrees_e7(fields[3], fields[4][0]);
+    current_gps_data.longitude_e7 = nmea_to_degrees_e7(fields[5], fields[6][0]);
+    current_gps_data.valid = 1;
+    
+    return 1;
 }
 
-float nmea_to_degrees(const char* coord, char direction) {
-    // Simplified implementation
-    return 0.0;
+static uint8_t nmea_hex_digit(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0xFF;
+}
+
+// Split "$GPGGA,a,b*hh" in place: every ',' and the '*' become '\0' and
+// fields[] points into the sentence (fields[0] = "$GPGGA"). The XOR checksum
+// is accumulated in the same pass. Returns the field count, 0 if invalid
+uint8_t nmea_tokenize(char* sentence, char** fields, uint8_t max_fields) {
+    if(sentence == NULL || sentence[0] != '$') {
+        return 0;
+    }
+    
+    uint8_t checksum = 0;
+    uint8_t count = 1;
+    char* p = sentence + 1;
+    fields[0] = sentence;
+    
+    for(; *p != '\0' && *p != '*'; p++) {
+        checksum ^= (uint8_t)*p;
+        if(*p == ',') {
+            *p = '\0';
+            if(count < max_fields) {
+                fields[count++] = p + 1;
+            }
+        }
+    }
+    
+    if(*p != '*') {
+        return 0;  // No checksum
+    }
+    *p = '\0';
+    
+    uint8_t hi = nmea_hex_digit(p[1]);
+    uint8_t lo = (hi != 0xFF) ? nmea_hex_digit(p[2]) : 0xFF;
+    if(lo == 0xFF || (uint8_t)((hi << 4) | lo) != checksum) {
+        return 0;
+    }
+    
+    return count;
+}
+
+// "ddmm.mmmm" / "dddmm.mmmm" + hemisphere -> 1e-7 degrees, integer only.
+// Minutes are read with 5 decimals (1e-5 min) and scaled by 1e7/(60*1e5) = 5/3
+int32_t nmea_to_degrees_e7(const char* coord, char direction) {
+    const char* dot = strchr(coord, '.');
+    if(dot == NULL || dot - coord < 3) {
+        return 0;
+    }
+    
+    // Degrees: everything before the two integer minute digits
+    int32_t degrees = 0;
+    for(const char* p = coord; p < dot - 2; p++) {
+        degrees = degrees * 10 + (*p - '0');
+    }
+    
+    // Minutes in 1e-5 units: mm + up to 5 decimals (zero padded)
+    uint32_t minutes_e5 = (dot[-2] - '0') * 10 + (dot[-1] - '0');
+    const char* p = dot + 1;
+    for(uint8_t i = 0; i < 5; i++) {
+        minutes_e5 *= 10;
+        if(*p >= '0' && *p <= '9') {
+            minutes_e5 += *p++ - '0';
+        }
+    }
+    
+    int32_t value = degrees * 10000000L + (int32_t)((minutes_e5 * 5 + 1) / 3);
+    
+    return (direction == 'S' || direction == 'W') ? -value : value;
+}
+
+// Signed decimal "-123.45" -> hundredths (-12345), integer only
+int32_t nmea_to_centi(const char* value) {
+    int32_t result = 0;
+    uint8_t negative = 0;
+    int8_t decimals = -1;
+    
+    if(*value == '-') {
+        negative = 1;
+        value++;
+    }
+    
+    for(; *value != '\0' && decimals < 2; value++) {
+        if(*value == '.') {
+            decimals = 0;
+        } else if(*value >= '0' && *value <= '9') {
+            result = result * 10 + (*value - '0');
+            if(decimals >= 0) decimals++;
+        } else {
+            break;
+        }
+    }
+    
+    // Pad to exactly two decimals
+    if(decimals < 0) decimals = 0;
+    for(; decimals < 2; decimals++) {
+        result *= 10;
+    }
+    
+    return negative ? -result : result;
 }
 
 uint8_t nmea_get_checksum(const char* sentence) {
@@ -148,17 +561,13 @@ uint8_t nmea_get_checksum(const char* sentence) {
 // PRN GENERATOR (T018 DSSS)
 // =============================================================================
 
-void generate_prn_sequence_i(int8_t* sequence, uint8_t mode) {
-    if(!prn_state_2g.initialized) {
-        // T.018 Official initial states
-        prn_state_2g.lfsr_i = 0x000001;    // Initial state I
-        prn_state_2g.lfsr_q = 0x000041;    // Initial state Q (64 offset)
-        prn_state_2g.initialized = 1;
-    }
-    
-    // Generate I-channel PRN sequence using T.018 LFSR (x^23 + x^18 + 1)
-    uint32_t lfsr = prn_state_2g.lfsr_i;
-    
+// T.018 official initial states
+#define PRN_LFSR_INIT_I     0x000001UL
+#define PRN_LFSR_INIT_Q     0x000041UL      // 64 offset
+
+// One bit worth of chips from the T.018 LFSR (x^23 + x^18 + 1), output on
+// the LSB. Returns the register state for the next bit
+static uint32_t prn_lfsr_fill(int8_t* sequence, uint32_t lfsr) {
     for(int i = 0; i < PRN_CHIPS_PER_BIT; i++) {
         // Extract output bit (LSB)
         sequence[i] = (lfsr & 1) ? 1 : -1;
@@ -171,25 +580,22 @@ void generate_prn_sequence_i(int8_t* sequence, uint8_t mode) {
         lfsr &= 0x7FFFFF;
     }
     
-    prn_state_2g.lfsr_i = lfsr;
+    return lfsr;
 }
 
-void generate_prn_sequence_q(int8_t* sequence, uint8_t mode) {
-    // Generate Q-channel PRN sequence using T.018 LFSR (same polynomial, offset state)
-    uint32_t lfsr = prn_state_2g.lfsr_q;
-    
-    for(int i = 0; i < PRN_CHIPS_PER_BIT; i++) {
-        sequence[i] = (lfsr & 1) ? 1 : -1;
-        
-        // T.018 LFSR feedback: x^23 + x^18 + 1 (same as I channel)
-        uint8_t feedback = ((lfsr >> 22) ^ (lfsr >> 17)) & 1;
-        lfsr = (lfsr >> 1) | ((uint32_t)feedback << 22);
-        
-        // Ensure 23-bit register (mask upper bits)
-        lfsr &= 0x7FFFFF;
+void generate_prn_sequence_i(int8_t* sequence, uint8_t mode) {
+    if(!prn_state_2g.initialized) {
+        prn_state_2g.lfsr_i = PRN_LFSR_INIT_I;
+        prn_state_2g.lfsr_q = PRN_LFSR_INIT_Q;
+        prn_state_2g.initialized = 1;
     }
     
-    prn_state_2g.lfsr_q = lfsr;
+    prn_state_2g.lfsr_i = prn_lfsr_fill(sequence, prn_state_2g.lfsr_i);
+}
+
+void generate_prn_sequence_q(int8_t* sequence, uint8_t mode) {
+    // Same polynomial as the I channel, offset state
+    prn_state_2g.lfsr_q = prn_lfsr_fill(sequence, prn_state_2g.lfsr_q);
 }
 
 void generate_full_prn_sequence(int8_t* sequence_i, int8_t* sequence_q, uint8_t mode) {
@@ -198,10 +604,13 @@ void generate_full_prn_sequence(int8_t* sequence_i, int8_t* sequence_q, uint8_t
 }
 
 uint8_t verify_prn_sequence(uint8_t mode) {
-    static int8_t test_seq_i[PRN_CHIPS_PER_BIT];
-    static int8_t test_seq_q[PRN_CHIPS_PER_BIT];
+    int8_t *test_seq_i = frame_arena.shared.selftest.prn_i;
+    int8_t *test_seq_q = frame_arena.shared.selftest.prn_q;
     
-    generate_full_prn_sequence(test_seq_i, test_seq_q, mode);
+    // Own LFSR state from the initial values: the deferred self-test runs
+    // after bursts have moved the transmit generator along its sequence
+    prn_lfsr_fill(test_seq_i, PRN_LFSR_INIT_I);
+    prn_lfsr_fill(test_seq_q, PRN_LFSR_INIT_Q);
     
     // T.018 verification - check first few chips against known values
     // Expected first chips for T.018 LFSR x^23+x^18+1, init=1: 1,0,0,0,0,0,0...
@@ -238,16 +647,22 @@ void reset_prn_generator(void) {
 // =============================================================================
 
 volatile uint8_t chip_timer_active = 0;
+uint32_t chip_timer_first_start_us = 0;
 
 void start_chip_timer(void) {
     // Start CCP1 for precise 38.4 kHz chip rate (already initialized)
     CCP1TMRL = 0;               // Clear counter
     CCP1TMRH = 0;               
+    chip_clock_reset();         // Restart fractional period schedule
     IFS0bits.CCP1IF = 0;        // Clear interrupt flag
     
     chip_timer_active = 1;
     CCP1CON1Lbits.CCPON = 1;    // Enable CCP1
     
+    if(chip_timer_first_start_us == 0) {
+        chip_timer_first_start_us = get_system_time_us();
+    }
+    
     DEBUG_LOG_FLUSH("T.018 CCP1 chip timer started (38.400 kHz)\r\n");
 }
 
@@ -262,8 +677,12 @@ void stop_chip_timer(void) {
 // OQPSK MODULATOR (T018 2nd Generation)
 // =============================================================================
 
+// MCP4922 command words per chip level (-1, 0, +1), I then Q, set per burst
+static uint16_t chip_dac_cmd[2][3];
+
 void oqpsk_init(void) {
     memset(&oqpsk_state_2g, 0, sizeof(oqpsk_state_t));
+    oqpsk_state_2g.frame_bits = frame_arena.shared.tx.frame_bits;
     
     // Initialize MCP4922 DAC for I/Q outputs
     mcp4922_init();
@@ -279,38 +698,56 @@ void build_2g_frame(uint8_t* info_data, uint8_t* output_frame) {
         output_frame[i] = (i % 2);
     }
     
-    // Information field (202 bits) - complete encoded frame from protocol_data
+    // Information field (202 bits) - packed codeword from protocol_data
     for(int i = 0; i < INFO_BITS; i++) {
         output_frame[PREAMBLE_BITS + i] = get_bit_field(info_data, i, 1);
     }
     
-    // BCH parity (48 bits) - extract from encoded frame
+    // BCH parity (48 bits) - packed right after the information field
     for(int i = 0; i < BCH_PARITY_BITS; i++) {
         output_frame[PREAMBLE_BITS + INFO_BITS + i] = 
             get_bit_field(info_data, INFO_BITS + i, 1);
     }
 }
 
-void oqpsk_transmit_frame(uint8_t* info_bits) {
+// Returns 0 when the burst was skipped (no PLL lock)
+uint8_t oqpsk_transmit_frame(uint8_t* info_bits) {
     DEBUG_LOG_FLUSH("Starting OQPSK transmission...\r\n");
     
     // Build complete transmission frame
     build_2g_frame(info_bits, oqpsk_state_2g.frame_bits);
     
+    // T.018: every burst is spread from the start of the PRN sequence
+    reset_prn_generator();
+    
+    // RF bring-up was started at the burst trigger: wait for whatever is
+    // left of the lock, then send the first chip straight away
+    if(!rf_enable_carrier(1)) {
+        DEBUG_LOG_FLUSH("PLL not locked - burst skipped\r\n");
+        rf_enable_carrier(0);
+        return 0;
+    }
+    
     // Initialize transmission state
     oqpsk_state_2g.transmitting = 1;
     oqpsk_state_2g.current_bit = 0;
     oqpsk_state_2g.current_symbol = 0;
-    oqpsk_state_2g.start_time = millis_counter;
+    oqpsk_state_2g.current_chip = 0;
+    oqpsk_state_2g.start_time = get_system_time_ms();
+    
+    // DAC command words for the three chip levels, calibration included
+    for(uint8_t level = 0; level < 3; level++) {
+        uint16_t dac = (uint16_t)(2048 + ((int16_t)level - 1) * 1000);
+        mcp4922_command_words(dac, dac, &chip_dac_cmd[0][level], &chip_dac_cmd[1][level]);
+    }
     
-    // Enable RF amplifier
-    rf_amplifier_enable(1);
+    // The CCP1 ISR owns SPI1 from here: fill the chip queue before the first tick
+    spi_stream_start();
+    transmission_task_2g();
     
     // Start T.018 hardware chip timer
     start_chip_timer();
-    
-    // Start transmission task (simplified version here)
-    transmission_task_2g();
+    return 1;
 }
 
 void oqpsk_test_iq_output(void) {
@@ -342,10 +779,11 @@ uint16_t oqpsk_get_bit_position(void) {
 void oqpsk_stop_transmission(void) {
     oqpsk_state_2g.transmitting = 0;
     
-    // Stop T.018 chip timer
+    // Stop T.018 chip timer, then take SPI1 back from the chip ISR
     stop_chip_timer();
+    spi_stream_stop();
     
-    rf_amplifier_enable(0);
+    rf_enable_carrier(0);
     mcp4922_write_both(2048, 2048);  // Center DACs
     
     DEBUG_LOG_FLUSH("T.018 transmission stopped\r\n");
@@ -358,7 +796,7 @@ void oqpsk_stop_transmission(void) {
 void start_beacon_transmission_2g(void) {
     if(!tx_state_2g.active) {
         tx_state_2g.phase = IDLE_STATE;
-        tx_state_2g.start_time = millis_counter;
+        tx_state_2g.start_time = get_system_time_ms();
         tx_state_2g.bit_position = 0;
         tx_state_2g.active = 1;
         
@@ -378,45 +816,52 @@ uint8_t is_transmission_active_2g(void) {
     return tx_state_2g.active;
 }
 
+// Chip producer: spreads bits into the SPI chip queue until it is full and
+// returns. The CCP1 ISR writes one queued I/Q pair per chip tick
 void transmission_task_2g(void) {
-    if(!oqpsk_state_2g.transmitting) return;
+    static int8_t prev_q_chip = 0;
+    int8_t *prn_i = frame_arena.shared.tx.prn_i;
+    int8_t *prn_q = frame_arena.shared.tx.prn_q;
     
-    // Simplified transmission - output bits with DSSS spreading
-    static int8_t prn_i[PRN_CHIPS_PER_BIT];
-    static int8_t prn_q[PRN_CHIPS_PER_BIT];
+    if(!oqpsk_state_2g.transmitting) return;
     
-    if(oqpsk_state_2g.current_bit < FRAME_TOTAL_BITS) {
-        uint8_t data_bit = oqpsk_state_2g.frame_bits[oqpsk_state_2g.current_bit];
+    while(oqpsk_state_2g.current_bit < FRAME_TOTAL_BITS) {
+        uint16_t chip = oqpsk_state_2g.current_chip;
+        
+        if(spi_chip_queue_depth() >= SPI_CHIP_QUEUE_SIZE) {
+            return;
+        }
         
         // Generate T.018 PRN chips for this bit (256 chips per bit)
-        generate_prn_sequence_i(prn_i, PRN_MODE_NORMAL);
-        generate_prn_sequence_q(prn_q, PRN_MODE_NORMAL);
+        if(chip == 0) {
+            if(oqpsk_state_2g.current_bit == 0) {
+                prev_q_chip = 0;        // No Q chip before the burst
+            }
+            generate_prn_sequence_i(prn_i, PRN_MODE_NORMAL);
+            generate_prn_sequence_q(prn_q, PRN_MODE_NORMAL);
+        }
         
         // T.018 DSSS spreading: XOR data bit with PRN chips
-        for(int i = 0; i < PRN_CHIPS_PER_BIT; i++) {
-            // DSSS spreading: bit XOR PRN
-            int8_t i_chip = data_bit ? prn_i[i] : -prn_i[i];
-            int8_t q_chip = data_bit ? prn_q[i] : -prn_q[i];
-            
-            // T.018 OQPSK: Apply half-symbol Q delay
-            static int8_t prev_q_chip = 0;
-            int8_t delayed_q = prev_q_chip;
-            prev_q_chip = q_chip;
-            
-            // Convert to 12-bit DAC values (MCP4922)
-            uint16_t i_dac = (uint16_t)(2048 + i_chip * 1000);
-            uint16_t q_dac = (uint16_t)(2048 + delayed_q * 1000);
-            
-            mcp4922_write_both(i_dac, q_dac);
-            
-            // T.018 timing: 38.4 kchips/sec = 26.041666µs per chip
-            // TODO: Replace with Timer2 ISR for precise hardware timing
-            __delay_us(26);
-        }
+        uint8_t data_bit = oqpsk_state_2g.frame_bits[oqpsk_state_2g.current_bit];
+        int8_t i_chip = data_bit ? prn_i[chip] : -prn_i[chip];
+        int8_t q_chip = data_bit ? prn_q[chip] : -prn_q[chip];
         
-        oqpsk_state_2g.current_bit++;
-    } else {
-        // Transmission complete
+        // T.018 OQPSK: Apply half-symbol Q delay
+        int8_t delayed_q = prev_q_chip;
+        prev_q_chip = q_chip;
+        
+        spi_queue_chip(chip_dac_cmd[0][i_chip + 1], chip_dac_cmd[1][delayed_q + 1]);
+        
+        if(++chip == PRN_CHIPS_PER_BIT) {
+            chip = 0;
+            oqpsk_state_2g.current_bit++;
+        }
+        oqpsk_state_2g.current_chip = chip;
+    }
+    
+    // Every chip queued: complete once the ISR has sent the last one
+    spi_stream_drain();
+    if(spi_chip_queue_depth() == 0) {
         oqpsk_stop_transmission();
     }
 }
@@ -425,74 +870,95 @@ void transmission_task_2g(void) {
 // BEACON TASK FUNCTIONS
 // =============================================================================
 
-void beacon_task_2g(void) {
-    uint32_t current_time = millis_counter;
-    uint8_t mode = get_beacon_mode_2g();
-    
-    // Update GPS data
-    gps_update();
+// Continuous TEST mode state
+static struct {
+    uint8_t next_ready;         // Frame N+1 already in the build region
+    uint16_t bursts;            // Bursts sent since the first one
+    uint16_t skipped;           // Bursts skipped (no PLL lock)
+    uint32_t first_start_ms;
+    uint32_t last_start_ms;
+} continuous_tx = {0, 0, 0, 0, 0};
+
+// Continuous TEST mode: each frame carries the next sequence number
+static void build_next_frame_2g(void) {
+    if(TEST_CONTINUOUS_MODE && beacon_config_2g.test_mode) {
+        frame_sequence_2g++;
+    }
+    build_compliant_frame_2g();
+}
+
+// Achieved rate over the bursts actually sent, first start to latest start
+static void continuous_tx_report(uint8_t sent) {
+    uint32_t now_ms = get_system_time_ms();
+    uint16_t rate_x100 = 0;
     
-    if(mode == MODE_TEST) {
-        // Test mode: transmit every 10 seconds
-        static uint32_t last_test_tx = 0;
-        
-        if(current_time - last_test_tx >= TEST_INTERVAL) {
-            DEBUG_LOG_FLUSH("TEST transmission\r\n");
-            transmit_beacon_2g();
-            last_test_tx = current_time;
+    if(sent) {
+        if(continuous_tx.bursts == 0) {
+            continuous_tx.first_start_ms = now_ms;
         }
+        continuous_tx.bursts++;
+        continuous_tx.last_start_ms = now_ms;
+    } else {
+        continuous_tx.skipped++;
     }
-    else {
-        // Exercise mode: ELT sequence
-        if(!elt_state_2g.active) {
-            start_elt_sequence_2g();
-        }
-        
-        uint32_t interval = get_current_interval_2g();
-        
-        if(current_time - elt_state_2g.last_tx_time >= interval) {
-            transmit_beacon_2g();
-            elt_state_2g.last_tx_time = current_time;
-            elt_state_2g.transmission_count++;
-            
-            check_phase_transition_2g();
-        }
+    
+    uint32_t elapsed_ms = continuous_tx.last_start_ms - continuous_tx.first_start_ms;
+    if(elapsed_ms != 0) {
+        rate_x100 = (uint16_t)(((uint64_t)(continuous_tx.bursts - 1) * 6000000UL) / elapsed_ms);
     }
+    DEBUG_EVENT4(MSG_CONTINUOUS_TX, frame_sequence_2g, frame_sequence_2g >> 16,
+                 rate_x100, continuous_tx.skipped);
 }
 
 void transmit_beacon_2g(void) {
-    DEBUG_LOG_FLUSH("\\r\\n=== TRANSMITTING 2G BEACON ===\\r\\n");
+    DEBUG_LOG_FLUSH("\r\n=== TRANSMITTING 2G BEACON ===\r\n");
     
-    // Build compliant frame
-    build_compliant_frame_2g();
+    uint8_t continuous = TEST_CONTINUOUS_MODE && beacon_config_2g.test_mode;
+    
+    // Build compliant frame, unless it was built during the previous burst
+    if(!continuous_tx.next_ready) {
+        build_next_frame_2g();
+    }
+    continuous_tx.next_ready = 0;
     
     // Debug output
-    char hex_id[24];
-    generate_23hex_id_2g(frame_2g_info, hex_id);
     DEBUG_LOG_FLUSH("23 HEX ID: ");
-    DEBUG_LOG_FLUSH(hex_id);
-    DEBUG_LOG_FLUSH("\\r\\n");
+    DEBUG_LOG_FLUSH(beacon_hex_id_2g());
+    DEBUG_LOG_FLUSH("\r\n");
     
-    // Start OQPSK transmission
-    oqpsk_transmit_frame(frame_2g_info);
+    // Start OQPSK transmission (copies the frame to the transmit region)
+    uint8_t sent = oqpsk_transmit_frame(frame_2g_info);
     
-    // Wait for completion
+    // Wait for completion: top up the chip queue, sleep until the next tick
     while(oqpsk_is_transmitting()) {
         transmission_task_2g();
+        if(spi_chip_queue_depth() >= SPI_CHIP_QUEUE_SIZE) {
+            // Queue full: 64 chips (1.7 ms) of lead covers a frame build
+            if(continuous && !continuous_tx.next_ready) {
+                build_next_frame_2g();
+                continuous_tx.next_ready = 1;
+                continue;
+            }
+            Idle();
+        } else if(spi_stream_draining_chips()) {
+            // Last chip queued: sleep through the drain, one wake-up per chip
+            Idle();
+        }
         
         // Update status LED
         if((oqpsk_get_bit_position() % 50) == 0) {
             toggle_status_led();
         }
-        system_delay_ms(1);
     }
     
-    DEBUG_LOG_FLUSH("2G transmission complete\\r\\n");
-}
-
-uint8_t should_transmit_beacon_2g(void) {
-    return (!is_transmission_active_2g() && 
-            ((millis_counter - tx_state_2g.last_tx_time) >= tx_interval_ms));
+    DEBUG_LOG_FLUSH("2G transmission complete\r\n");
+    
+    // Re-encode stale rotating blocks now so the next build is a lookup
+    rf_sched_refresh_2g();
+    
+    if(continuous) {
+        continuous_tx_report(sent);
+    }
 }
 
 // Set transmission interval
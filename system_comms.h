@@ -17,19 +17,65 @@
 #define NMEA_BUFFER_SIZE    128
 #define NMEA_MAX_FIELDS     20
 
+// UART2 RX ring (power of 2). Filled by _U2RXInterrupt, drained by gps_update()
+// Sized for a 2 s blocking burst with GGA+RMC at 1 Hz (~150 bytes/s), doubled
+// with RAM reclaimed by the frame arena to cover GSV/GSA bursts as well
+#define GPS_RX_BUFFER_SIZE  1024
+#define GPS_RX_ISR_IPL      3       // Below T1 wake-up and CNB lock detect (4), CCP1 chip clock (5)
+
+// UART2 receive statistics
+typedef struct {
+    uint16_t ring_overruns;     // Bytes lost because the ring was full
+    uint16_t hw_overruns;       // UART2 hardware FIFO overruns (OERR)
+    uint16_t high_water;        // Maximum ring occupancy seen by gps_update()
+} gps_rx_stats_t;
+
 // GPS functions
 void gps_init(void);
 uint8_t gps_update(void);
+gps_rx_stats_t* gps_get_rx_stats(void);
+void gps_report_rx_stats(void);
 gps_data_t* get_current_gps_data(void);
 gps_data_t* get_test_position(void);
 
-// NMEA parsing functions
-uint8_t parse_nmea_sentence(const char* sentence);
-uint8_t parse_gga(const char* sentence);
-uint8_t parse_rmc(const char* sentence);
+// NMEA parsing functions (sentence is tokenized in place)
+uint8_t parse_nmea_sentence(char* sentence);
+uint8_t parse_gga(char** fields, uint8_t num_fields);
+uint8_t parse_rmc(char** fields, uint8_t num_fields);
+
+// TSIP framing: DLE <id> <data, DLE doubled> DLE ETX
+#define TSIP_DLE            0x10
+#define TSIP_ETX            0x03
+#define TSIP_BUFFER_SIZE    72      // Largest report used (0x8F-20) is 56 bytes
+#define TSIP_ID_SUPER       0x8F    // Superpacket, subcode in first data byte
+#define TSIP_SUB_FIX_EXTRA  0x20    // Last fix with extra info (fixed point)
+#define TSIP_SUB_TIMING     0xAB    // Primary timing packet (UTC date/time)
+
+// 0x8F-AB timing flags (byte 9)
+#define TSIP_TIMING_UTC     0x01    // Date/time fields are UTC, else GPS time
+#define TSIP_TIMING_NOT_SET 0x04    // Receiver has no time yet
+#define TSIP_TIMING_NO_UTC  0x08    // GPS-UTC offset not received yet
+
+// 0x8F-20 altitude is above the WGS-84 ellipsoid and the report carries no
+// geoid model; T.018 encodes height above mean sea level. The geoid
+// separation N (MSL = HAE - N) at the operating site is set here, e.g. about
+// +49 m around Grenoble. Left at 0 the encoded altitude is off by N, which
+// stays within +/-110 m world-wide
+#ifndef TSIP_GEOID_SEPARATION_CM
+#define TSIP_GEOID_SEPARATION_CM    0L
+#endif
+
+// TSIP functions
+uint8_t tsip_process_byte(uint8_t c);
+uint8_t parse_tsip_packet(uint8_t id, const uint8_t* data, uint8_t len);
+uint8_t parse_tsip_fix(const uint8_t* data, uint8_t len);
+uint8_t parse_tsip_timing(const uint8_t* data, uint8_t len);
 
 // Utility functions
-float nmea_to_degrees(const char* coord, char direction);
+uint8_t nmea_process_byte(char c);
+uint8_t nmea_tokenize(char* sentence, char** fields, uint8_t max_fields);
+int32_t nmea_to_degrees_e7(const char* coord, char direction);
+int32_t nmea_to_centi(const char* value);
 uint8_t nmea_get_checksum(const char* sentence);
 
 // =============================================================================
@@ -46,14 +92,15 @@ typedef struct {
     uint8_t transmitting;
     uint16_t current_bit;
     uint16_t current_symbol;
-    uint8_t frame_bits[252];
+    uint8_t *frame_bits;        // Transmit region of the frame arena
     uint32_t start_time;
+    uint16_t current_chip;      // Next chip of current_bit to queue
 } oqpsk_state_t;
 
 // OQPSK functions
 void oqpsk_init(void);
 void build_2g_frame(uint8_t* info_data, uint8_t* output_frame);
-void oqpsk_transmit_frame(uint8_t* info_bits);
+uint8_t oqpsk_transmit_frame(uint8_t* info_bits);
 void oqpsk_test_iq_output(void);
 
 // OQPSK status functions
@@ -101,6 +148,7 @@ void reset_prn_generator(void);
 void start_chip_timer(void);
 void stop_chip_timer(void);
 extern volatile uint8_t chip_timer_active;
+extern uint32_t chip_timer_first_start_us;     // First chip since reset (0 = none yet)
 
 // =============================================================================
 // TRANSMISSION CONTROL
@@ -124,8 +172,6 @@ uint8_t is_transmission_active_2g(void);
 void transmission_task_2g(void);
 
 // Beacon task functions
-void beacon_task_2g(void);
-uint8_t should_transmit_beacon_2g(void);
 void transmit_beacon_2g(void);
 void set_tx_interval(uint32_t interval);
 
@@ -157,6 +203,5 @@ extern gps_data_t test_position_2g;
 
 // Timing constants
 extern uint32_t tx_interval_ms;
-extern volatile uint32_t millis_counter;
 
 #endif /* SYSTEM_COMMS_H */
\ No newline at end of file
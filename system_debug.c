@@ -2,13 +2,96 @@
  * Debug logging implementation for COSPAS-SARSAT beacon
  */
 
+#include "includes.h"
 #include "system_debug.h"
 #include "system_definitions.h"
 #include <string.h>
 #include <stdio.h>
 
-// Debug buffer for formatting
+// UART1 TX ring buffer (producers: main loop + ISRs up to DEBUG_TX_IPL,
+// consumer: _U1TXInterrupt)
 static char debug_buffer[DEBUG_BUFFER_SIZE];
+static volatile uint16_t debug_tx_head = 0;     // Next write index
+static volatile uint16_t debug_tx_tail = 0;     // Next read index
+static debug_tx_stats_t debug_tx_stats = {0, 0, 0, 0};
+
+#define DEBUG_TX_MASK   (DEBUG_BUFFER_SIZE - 1)
+
+// Enqueue a complete message without blocking. The message is either copied
+// whole or dropped (and counted) so the UART never carries truncated lines
+uint8_t debug_tx_enqueue(const char* data, uint16_t len) {
+    #if DEBUG_ENABLED
+    uint16_t saved_ipl;
+    uint16_t t_start = SYSTEM_TIME_US16();
+    
+    SET_AND_SAVE_CPU_IPL(saved_ipl, DEBUG_TX_IPL);
+    
+    uint16_t head = debug_tx_head;
+    uint16_t used = (head - debug_tx_tail) & DEBUG_TX_MASK;
+    uint16_t free_bytes = DEBUG_TX_MASK - used;
+    
+    if(len > free_bytes) {
+        debug_tx_stats.dropped_msgs++;
+        debug_tx_stats.dropped_bytes += len;
+        RESTORE_CPU_IPL(saved_ipl);
+        return 0;
+    }
+    
+    for(uint16_t i = 0; i < len; i++) {
+        debug_buffer[head] = data[i];
+        head = (head + 1) & DEBUG_TX_MASK;
+    }
+    debug_tx_head = head;
+    
+    used += len;
+    if(used > debug_tx_stats.high_water) {
+        debug_tx_stats.high_water = used;
+    }
+    
+    // Kick the drain interrupt (fires while the TX FIFO has room)
+    IEC0bits.U1TXIE = 1;
+    
+    // Enqueue cost from the microsecond time base
+    uint16_t elapsed_us = SYSTEM_TIME_US16() - t_start;
+    if(elapsed_us > debug_tx_stats.enqueue_max_us) {
+        debug_tx_stats.enqueue_max_us = elapsed_us;
+    }
+    
+    RESTORE_CPU_IPL(saved_ipl);
+    return 1;
+    #else
+    return 0;
+    #endif
+}
+
+// True once every queued byte has been handed to the UART
+uint8_t debug_tx_is_idle(void) {
+    return (debug_tx_head == debug_tx_tail);
+}
+
+debug_tx_stats_t* debug_get_tx_stats(void) {
+    return &debug_tx_stats;
+}
+
+// UART1 TX interrupt - refill the hardware FIFO from the ring
+void __attribute__((__interrupt__, __auto_psv__)) _U1TXInterrupt(void) {
+    ISR_ENTER(ISR_ID_U1TX);
+    uint16_t tail = debug_tx_tail;
+    
+    while(!U1STAHbits.UTXBF && (tail != debug_tx_head)) {
+        U1TXREG = debug_buffer[tail];
+        tail = (tail + 1) & DEBUG_TX_MASK;
+    }
+    debug_tx_tail = tail;
+    
+    // Nothing left to send: stop interrupting until the next enqueue
+    if(tail == debug_tx_head) {
+        IEC0bits.U1TXIE = 0;
+    }
+    
+    IFS0bits.U1TXIF = 0;
+    ISR_EXIT();
+}
 
 // Initialize debug system
 void debug_init(void) {
@@ -19,21 +102,76 @@ void debug_init(void) {
     debug_print_string("=====================================\r\n");
 }
 
-// Print string via UART
-void debug_print_string(const char* str) {
+#if DEBUG_OUTPUT_MODE == DEBUG_MODE_ASCII
+// Decimal digits of value, most significant first. Returns the digit count
+static uint8_t debug_format_dec16(char* out, uint16_t value) {
+    char digits[5];
+    uint8_t n = 0;
+    uint8_t len = 0;
+    
+    do {
+        digits[n++] = '0' + (value % 10);
+        value /= 10;
+    } while(value > 0);
+    
+    while(n > 0) {
+        out[len++] = digits[--n];
+    }
+    return len;
+}
+#endif
+
+// Emit one event as a single ring enqueue, so lines from an ISR never land
+// inside it. Binary mode: 5 + 2*nargs bytes, no number formatting on
+// target. ASCII mode: "#id arg arg\r\n"
+void debug_event(debug_msg_id_t id, const uint16_t* args, uint8_t nargs) {
     #if DEBUG_ENABLED
-    while(*str) {
-        debug_print_char(*str++);
+    if(nargs > DEBUG_BINLOG_MAX_ARGS) {
+        nargs = DEBUG_BINLOG_MAX_ARGS;
+    }
+    
+    #if DEBUG_OUTPUT_MODE == DEBUG_MODE_BINARY
+    char record[5 + 2 * DEBUG_BINLOG_MAX_ARGS];
+    uint16_t timestamp = (uint16_t)get_system_time_ms();
+    
+    record[0] = DEBUG_BINLOG_SYNC;
+    record[1] = (char)id;
+    record[2] = (char)nargs;
+    record[3] = (char)(timestamp & 0xFF);
+    record[4] = (char)(timestamp >> 8);
+    for(uint8_t i = 0; i < nargs; i++) {
+        record[5 + 2 * i] = (char)(args[i] & 0xFF);
+        record[6 + 2 * i] = (char)(args[i] >> 8);
     }
+    debug_tx_enqueue(record, 5 + 2 * nargs);
+    #else
+    char line[1 + 5 + 6 * DEBUG_BINLOG_MAX_ARGS + 2];
+    uint8_t len = 0;
+    
+    line[len++] = '#';
+    len += debug_format_dec16(&line[len], (uint16_t)id);
+    for(uint8_t i = 0; i < nargs; i++) {
+        line[len++] = ' ';
+        len += debug_format_dec16(&line[len], args[i]);
+    }
+    line[len++] = '\r';
+    line[len++] = '\n';
+    debug_tx_enqueue(line, len);
+    #endif
+    #endif
+}
+
+// Print string via UART (queued, never blocks)
+void debug_print_string(const char* str) {
+    #if DEBUG_TEXT_ENABLED
+    debug_tx_enqueue(str, strlen(str));
     #endif
 }
 
-// Print single character
+// Print single character (queued, never blocks)
 void debug_print_char(char c) {
-    #if DEBUG_ENABLED
-    // Wait for transmit buffer to be empty
-    while(U1STAbits.UTXBF);
-    U1TXREG = c;
+    #if DEBUG_TEXT_ENABLED
+    debug_tx_enqueue(&c, 1);
     #endif
 }
 
@@ -64,17 +202,17 @@ void debug_print_dec(uint32_t value) {
     }
     
     char buffer[12];  // Max for 32-bit: 4294967295
-    int i = 0;
+    int i = sizeof(buffer);
     
+    // Fill from the end so the digits are enqueued as one message
     while(value > 0) {
-        buffer[i++] = '0' + (value % 10);
+        buffer[--i] = '0' + (value % 10);
         value /= 10;
     }
     
-    // Print in reverse order
-    while(i > 0) {
-        debug_print_char(buffer[--i]);
-    }
+    #if DEBUG_TEXT_ENABLED
+    debug_tx_enqueue(&buffer[i], sizeof(buffer) - i);
+    #endif
 }
 
 // Print floating point value
@@ -217,13 +355,19 @@ void debug_print_time(uint8_t day, uint8_t hour, uint8_t minute) {
 void debug_print_system_status(void) {
     debug_print_string("System Status:\r\n");
     debug_print_string("  Uptime: ");
-    debug_print_dec(millis_counter / 1000);
+    debug_print_dec(get_system_time_ms() / 1000);
     debug_print_string(" seconds\r\n");
     debug_print_string("  Free RAM: ");
     // TODO: Implement stack pointer check for free RAM
     debug_print_string("Unknown\r\n");
 }
 
+// UART1 TX ring statistics
+void debug_report_tx_stats(void) {
+    DEBUG_EVENT5(MSG_DEBUG_TX_STATS, debug_tx_stats.dropped_msgs, debug_tx_stats.dropped_bytes,
+                 debug_tx_stats.high_water, DEBUG_BUFFER_SIZE - 1, debug_tx_stats.enqueue_max_us);
+}
+
 // Print memory usage
 void debug_print_memory_usage(void) {
     debug_print_string("Memory Usage:\r\n");
@@ -6,24 +6,113 @@
 #define SYSTEM_DEBUG_H
 
 #include <stdint.h>
+#include <stddef.h>
 
-// Debug buffer size
-#define DEBUG_BUFFER_SIZE 256
+// Debug output on UART1 (0 = compiled out)
+#ifndef DEBUG_ENABLED
+#define DEBUG_ENABLED 1
+#endif
 
-// Debug macros (used throughout the code)
-#define DEBUG_LOG_FLUSH(msg)    // Empty for now
-#define DEBUG_LOG_INFO(msg)     // Empty for now  
-#define DEBUG_LOG_ERROR(msg)    // Empty for now
-#define DEBUG_LOG_WARN(msg)     // Empty for now
-#define DEBUG_LOG_ISR(msg)      // Empty for now
+// Debug output format: ASCII text or compact binary records
+#define DEBUG_MODE_ASCII        0
+#define DEBUG_MODE_BINARY       1
+#ifndef DEBUG_OUTPUT_MODE
+#define DEBUG_OUTPUT_MODE       DEBUG_MODE_ASCII
+#endif
+
+// UART1 TX ring buffer size (power of 2)
+#define DEBUG_BUFFER_SIZE 512
+
+// Highest IPL of any code that logs. Enqueue raises the CPU to this level for
+// a few cycles, so the CCP1 chip clock (IPL 5) is never delayed by logging
+#define DEBUG_TX_IPL            4
+#define DEBUG_TX_ISR_IPL        1   // UART1 TX drain interrupt priority
+
+// Debug macros (used throughout the code) - non-blocking, drop when full
+// Text messages are not emitted in binary mode (they would corrupt the record
+// stream); events below are emitted in both modes
+#define DEBUG_TEXT_ENABLED      (DEBUG_ENABLED && (DEBUG_OUTPUT_MODE == DEBUG_MODE_ASCII))
+
+#if DEBUG_TEXT_ENABLED
+#define DEBUG_LOG_FLUSH(msg)    debug_print_string(msg)
+#define DEBUG_LOG_INFO(msg)     debug_print_string(msg)
+#define DEBUG_LOG_ERROR(msg)    debug_print_string(msg)
+#define DEBUG_LOG_WARN(msg)     debug_print_string(msg)
+#define DEBUG_LOG_ISR(msg)      debug_print_string(msg)
+#else
+#define DEBUG_LOG_FLUSH(msg)
+#define DEBUG_LOG_INFO(msg)
+#define DEBUG_LOG_ERROR(msg)
+#define DEBUG_LOG_WARN(msg)
+#define DEBUG_LOG_ISR(msg)
+#endif
+
+// =============================================================================
+// BINARY EVENT LOG (deferred formatting)
+// =============================================================================
+// Record: 0xA5 | id | nargs | timestamp ms (16-bit LE) | nargs x 16-bit LE words
+// Formatting happens on the host (tools/binlog_decode.py) from the string
+// table in system_debug_msgs.h. In ASCII mode the same events print as
+// "#id arg arg ..." so call sites never change
+
+#define DEBUG_BINLOG_SYNC       0xA5
+#define DEBUG_BINLOG_MAX_ARGS   6
+
+typedef enum {
+#define DEBUG_MSG(id, name, fmt) name = id,
+#include "system_debug_msgs.h"
+#undef DEBUG_MSG
+} debug_msg_id_t;
+
+void debug_event(debug_msg_id_t id, const uint16_t* args, uint8_t nargs);
+
+#if DEBUG_ENABLED
+#define DEBUG_EVENT0(id)            debug_event((id), NULL, 0)
+#define DEBUG_EVENT1(id, a)         do { const uint16_t _ev[1] = {(uint16_t)(a)}; \
+                                         debug_event((id), _ev, 1); } while(0)
+#define DEBUG_EVENT2(id, a, b)      do { const uint16_t _ev[2] = {(uint16_t)(a), (uint16_t)(b)}; \
+                                         debug_event((id), _ev, 2); } while(0)
+#define DEBUG_EVENT3(id, a, b, c)   do { const uint16_t _ev[3] = {(uint16_t)(a), (uint16_t)(b), (uint16_t)(c)}; \
+                                         debug_event((id), _ev, 3); } while(0)
+#define DEBUG_EVENT4(id, a, b, c, d) do { const uint16_t _ev[4] = {(uint16_t)(a), (uint16_t)(b), (uint16_t)(c), (uint16_t)(d)}; \
+                                         debug_event((id), _ev, 4); } while(0)
+#define DEBUG_EVENT5(id, a, b, c, d, e) do { const uint16_t _ev[5] = {(uint16_t)(a), (uint16_t)(b), (uint16_t)(c), (uint16_t)(d), (uint16_t)(e)}; \
+                                         debug_event((id), _ev, 5); } while(0)
+#define DEBUG_EVENT6(id, a, b, c, d, e, f) do { const uint16_t _ev[6] = {(uint16_t)(a), (uint16_t)(b), (uint16_t)(c), (uint16_t)(d), (uint16_t)(e), (uint16_t)(f)}; \
+                                         debug_event((id), _ev, 6); } while(0)
+#else
+#define DEBUG_EVENT0(id)
+#define DEBUG_EVENT1(id, a)
+#define DEBUG_EVENT2(id, a, b)
+#define DEBUG_EVENT3(id, a, b, c)
+#define DEBUG_EVENT4(id, a, b, c, d)
+#define DEBUG_EVENT5(id, a, b, c, d, e)
+#define DEBUG_EVENT6(id, a, b, c, d, e, f)
+#endif
+
+// TX ring statistics
+typedef struct {
+    uint16_t dropped_msgs;      // Messages rejected because the ring was full
+    uint16_t dropped_bytes;     // Bytes of those messages
+    uint16_t high_water;        // Maximum ring occupancy (bytes)
+    uint16_t enqueue_max_us;    // Worst-case enqueue cost (1 us resolution)
+} debug_tx_stats_t;
 
 // Debug initialization
 void debug_init(void);
 
+// UART1 TX ring (drained by _U1TXInterrupt)
+uint8_t debug_tx_enqueue(const char* data, uint16_t len);
+uint8_t debug_tx_is_idle(void);
+debug_tx_stats_t* debug_get_tx_stats(void);
+
 // Debug print functions  
+void debug_print_char(char c);
 void debug_print_dec(uint32_t value);
 void debug_print_hex(uint8_t value);
+void debug_print_hex16(uint16_t value);
 void debug_print_float(float value, uint8_t decimals);
 void debug_print_string(const char* str);
+void debug_report_tx_stats(void);
 
 #endif /* SYSTEM_DEBUG_H */
\ No newline at end of file
@@ -0,0 +1,25 @@
+/* system_debug_msgs.h
+ * Binary log message table (X-macro)
+ * Single source for the firmware IDs and the host decoder string table
+ * (tools/binlog_decode.py parses this file - keep one entry per line)
+ */
+
+// DEBUG_MSG(id, name, format) - %u = one 16-bit word, %lu = two words (lo, hi)
+DEBUG_MSG(0x01, MSG_BOOT,               "Beacon ready - mode %u (0=TEST, 1=EXERCISE)")
+DEBUG_MSG(0x02, MSG_BOOT_TIMING,        "Reset to ready %lu us, to first chip %lu us")
+DEBUG_MSG(0x03, MSG_POST_RESULT,        "Self-tests %u (0=run at boot, 1=cached, 2=deferred run) flags %u")
+DEBUG_MSG(0x04, MSG_FRAME_ARENA,        "Frame arena %u bytes: build %u, transmit %u, self-test %u")
+DEBUG_MSG(0x10, MSG_TX_START,           "TX start: mode=%u elt_phase=%u")
+DEBUG_MSG(0x12, MSG_ELT_TX,             "ELT transmission #%u in phase %u")
+DEBUG_MSG(0x13, MSG_CONTINUOUS_TX,      "Continuous TX seq %lu: %u bursts/min x100, %u skipped")
+DEBUG_MSG(0x20, MSG_GPS_RX_STATS,       "GPS RX: %u ring overruns, %u UART overruns, high water %u of %u bytes")
+DEBUG_MSG(0x30, MSG_RF_POWER,           "RF power level %u")
+DEBUG_MSG(0x31, MSG_RF_FREQ,            "ADF7012 frequency %lu Hz")
+DEBUG_MSG(0x32, MSG_RF_ENABLE_TIMING,   "Trigger to RF enable %lu us, max PLL lock %u us, ADF words written %u skipped %u")
+DEBUG_MSG(0x33, MSG_RF_LOCK_STATS,      "PLL lock %u us (min %u, avg %u, max %u) over %u locks, %u timeouts")
+DEBUG_MSG(0x34, MSG_SPI_QUEUE_STATS,    "SPI chip queue min %u, %u underruns; config queue max %u, wait max %u us, %u written, %u stalls")
+DEBUG_MSG(0x40, MSG_DEBUG_TX_STATS,     "Debug TX: %u msgs / %u bytes dropped, high water %u of %u bytes, enqueue max %u us")
+DEBUG_MSG(0x50, MSG_SCHED_LATENCY,      "Job %u: runs=%u max dispatch latency %lu us")
+DEBUG_MSG(0x51, MSG_POWER_DUTY,         "Cycle in phase %u (0=TEST): CPU active %u permille over %u ms")
+DEBUG_MSG(0x52, MSG_STACK_USAGE,        "Stack %u of %u bytes used, %u at deepest ISR entry")
+DEBUG_MSG(0x53, MSG_ISR_NESTING,        "ISR nesting max: CCP1 %u CCT2 %u T1 %u U2RX %u U1TX %u CNB %u")
@@ -8,14 +8,127 @@
 #include <xc.h>
 #include <stdint.h>
 
-// Global system timer counter (expected by beacon_2g_main.c:293)
-extern volatile uint32_t millis_counter;
-
 // Hardware abstraction functions (expected by beacon_2g_main.c)
 void toggle_status_led(void);
 void system_init(void);
 uint32_t get_system_time_ms(void);
+uint32_t get_system_time_us(void);
 void system_delay_ms(uint16_t ms);
+
+// Low word of the microsecond time base, for short interval measurements
+#define SYSTEM_TIME_US16()   (CCP2TMRL)
+
+// Program flash self-programming (data kept in the low 16 bits of each
+// 24-bit instruction word; addresses are program counter units, 2 per word)
+#define FLASH_PAGE_SIZE_ADDR    0x800UL     // Erase page: 1024 instruction words
+#define FLASH_ERASED_WORD       0xFFFF
+#define FLASH_PROGRAM_END_ADDR  0xB000UL    // End of user flash (22K words, config words included)
+
+uint16_t flash_read_word(uint32_t addr);
+uint8_t flash_read_high_byte(uint32_t addr);
+uint8_t flash_write_words(uint32_t addr, const uint16_t* words, uint16_t count);
+uint8_t flash_erase_page(uint32_t addr);
+
+// Power management - CPU Idle between events (see cpu_idle_until_us())
+typedef struct {
+    uint32_t idle_us;           // Time spent in Idle (wraps after ~71 min)
+    uint32_t wakeups;           // Idle exits
+} power_stats_t;
+
+void cpu_idle_until_us(uint32_t deadline_us);
+const power_stats_t* get_power_stats(void);
+
+// Stack usage - the free stack is painted at boot and the high-water mark is
+// found by scanning down from the limit. Every ISR brackets its body with
+// ISR_ENTER/ISR_EXIT, which track nesting per vector and sample the stack
+// pointer (the only measure available on a host build, where nothing is painted)
+typedef enum {
+    ISR_ID_CCP1 = 0,            // Chip clock (IPL 5)
+    ISR_ID_CCT2,                // Time base wrap (IPL 6)
+    ISR_ID_T1,                  // Idle wake-up (IPL 4)
+    ISR_ID_U2RX,                // GPS receive (IPL 3)
+    ISR_ID_U1TX,                // Debug drain (IPL 1)
+    ISR_ID_CNB,                 // PLL lock detect edge (IPL 4)
+    ISR_NUM_IDS
+} isr_id_t;
+
+typedef struct {
+    uint16_t size;                      // Stack bytes, start to limit
+    uint16_t used;                      // High-water mark, bytes from start
+    uint16_t isr_entry_max;             // Deepest stack sampled at ISR entry
+    uint8_t nesting_max[ISR_NUM_IDS];   // Deepest nesting seen inside each ISR
+} stack_stats_t;
+
+#if defined(__XC16__) || defined(__XC_DSC__)
+extern uint16_t __SP_init;              // Linker symbol: stack start, grows up
+#define STACK_POINTER()     ((uintptr_t)WREG15)
+#define STACK_DEPTH(sp)     ((uint16_t)((sp) - (uintptr_t)&__SP_init))
+#else
+extern uintptr_t stack_host_base;       // Frame of stack_paint(), stack grows down
+#define STACK_POINTER()     ((uintptr_t)__builtin_frame_address(0))
+#define STACK_DEPTH(sp)     ((uint16_t)(stack_host_base - (sp)))
+#endif
+
+extern volatile uint8_t isr_nesting;
+extern volatile uint8_t isr_nesting_max[ISR_NUM_IDS];
+extern volatile uint16_t isr_entry_depth_max;
+
+// A preempting ISR always restores isr_nesting before returning, so the
+// read-modify-write needs no interrupt masking
+static inline void isr_enter(isr_id_t id) {
+    uint8_t depth = ++isr_nesting;
+    if(depth > isr_nesting_max[id]) {
+        isr_nesting_max[id] = depth;
+    }
+    uint16_t used = STACK_DEPTH(STACK_POINTER());
+    if(used > isr_entry_depth_max) {
+        isr_entry_depth_max = used;
+    }
+}
+
+#define ISR_ENTER(id)       isr_enter(id)
+#define ISR_EXIT()          (isr_nesting--)
+
+void stack_paint(void);
+uint16_t stack_high_water(void);
+void get_stack_stats(stack_stats_t* stats);
+void stack_report(void);
+
+// Cooperative scheduler - timed jobs run from main() in deadline order
+// (ties go to the lower job ID). All transmit decisions belong to SCHED_JOB_TX
+typedef enum {
+    SCHED_JOB_GPS = 0,          // Drain GPS RX ring, parse sentences
+    SCHED_JOB_TX,               // Beacon burst deadline (one-shot, re-armed per burst)
+    SCHED_JOB_LED,              // Status LED heartbeat
+    SCHED_JOB_RF_STATUS,        // RF status refresh
+    SCHED_JOB_SELFTEST,         // Deferred power-on self-tests (one-shot)
+    SCHED_NUM_JOBS
+} sched_job_id_t;
+
+typedef void (*sched_job_fn_t)(void);
+
+typedef struct {
+    sched_job_fn_t fn;
+    uint32_t deadline_us;       // Next due time (get_system_time_us)
+    uint32_t period_us;         // 0 = one-shot, job re-arms itself
+    uint8_t armed;
+    uint16_t runs;
+    uint32_t last_latency_us;   // Deadline to dispatch
+    uint32_t max_latency_us;
+} sched_job_t;
+
+void sched_add_job(sched_job_id_t id, sched_job_fn_t fn, uint32_t deadline_us, uint32_t period_us);
+void sched_set_deadline(sched_job_id_t id, uint32_t deadline_us);
+void sched_cancel(sched_job_id_t id);
+const sched_job_t* sched_get_job(sched_job_id_t id);
+void sched_run(void);
+void sched_print_stats(void);
+
+// T.018 chip clock (CCP1, fractional-N period dithering)
+extern volatile uint16_t chip_tick_count;
+void chip_clock_reset(void);
+int32_t chip_clock_burst_error(uint32_t num_chips);
+uint8_t verify_chip_clock_schedule(void);
 extern volatile unsigned int __attribute__((__sfr__)) _RP20R;
 
 // Bit field manipulation functions
@@ -36,6 +149,10 @@ uint64_t get_bit_field_64(const uint8_t* buffer, uint16_t start_bit, uint8_t num
 #define STATUS_LED_LAT       LATDbits.LATD10
 #define ADF_CS_TRIS          TRISBbits.TRISB1   // SPI CS for ADF7012
 #define ADF_CS_LAT           LATBbits.LATB1
+#define ADF_MUXOUT_TRIS      TRISBbits.TRISB0   // ADF7012 MUXOUT (lock detect)
+#define ADF_MUXOUT_PORT      PORTBbits.RB0
+#define ADF4351_CS_TRIS      TRISAbits.TRISA3   // SPI LE for ADF4351 (LO)
+#define ADF4351_CS_LAT       LATAbits.LATA3
 #define LED_TOGGLE()         (LED_TX_PIN = !LED_TX_PIN)
 
 // MCP4922 Dual DAC pins
@@ -72,6 +189,15 @@ uint64_t get_bit_field_64(const uint8_t* buffer, uint16_t start_bit, uint8_t num
 
 #define TEST_INTERVAL           10000   // 10 seconds for test mode
 
+// Continuous TEST mode for decoder stress testing: bursts back to back with
+// a minimum end-to-start gap, frame N+1 built while frame N is on air
+#ifndef TEST_CONTINUOUS_MODE
+#define TEST_CONTINUOUS_MODE    0
+#endif
+#ifndef TEST_CONTINUOUS_GAP_MS
+#define TEST_CONTINUOUS_GAP_MS  100
+#endif
+
 // =============================
 // T.018 DSSS Parameters (COSPAS-SARSAT Official)
 // =============================
@@ -83,6 +209,16 @@ uint64_t get_bit_field_64(const uint8_t* buffer, uint16_t start_bit, uint8_t num
 #define INFO_BITS               202         // Information bits
 #define BCH_PARITY_BITS         48          // BCH parity bits
 
+// CCP1 chip clock: FCY / CHIP_RATE_HZ = 2604 + 1/6 cycles per chip.
+// The fractional part is dithered by a phase accumulator (5 x 2604 + 1 x 2605)
+#define CHIP_PERIOD_CYCLES      (FCY / CHIP_RATE_HZ)    // 2604 cycles
+#define CHIP_PERIOD_FRAC        (FCY % CHIP_RATE_HZ)    // 6400 / 38400 = 1/6 cycle
+#define CHIPS_PER_BURST         ((uint32_t)FRAME_TOTAL_BITS * SPREADING_FACTOR)
+
+// Chip stream queue (I/Q DAC word pairs, power of 2): 64 chips = 1.7 ms of
+// lead between the modulator and the CCP1 ISR that writes the DAC
+#define SPI_CHIP_QUEUE_SIZE     64
+
 // PRN LFSR Polynomial: x^23 + x^18 + 1
 #define PRN_LFSR_TAPS           0x040040001UL
 #define PRN_LFSR_PERIOD         8388607     // 2^23 - 1
@@ -98,20 +234,36 @@ uint64_t get_bit_field_64(const uint8_t* buffer, uint16_t start_bit, uint8_t num
 #define RF_TYPE_RLS             2
 #define RF_TYPE_CANCEL          3
 
+// Rotating field cycle per mode, one type per burst, repeated (up to 8
+// entries). Every listed type is pre-encoded, e.g. { RF_TYPE_ELTDT, RF_TYPE_RLS }
+#ifndef RF_CYCLE_TEST
+#define RF_CYCLE_TEST           { RF_TYPE_G008 }
+#endif
+#ifndef RF_CYCLE_EXERCISE
+#define RF_CYCLE_EXERCISE       { RF_TYPE_ELTDT }
+#endif
+
 // =============================
 // GPS Configuration
 // =============================
 #define GPS_BAUDRATE            9600    // Trimble 63530-00 baud rate
 
+// GPS link protocol (Copernicus II speaks both on its serial ports)
+#define GPS_PROTOCOL_NMEA       0       // NMEA 0183 ASCII (GGA/RMC)
+#define GPS_PROTOCOL_TSIP       1       // Trimble TSIP binary (0x8F-20 / 0x8F-AB)
+#ifndef GPS_PROTOCOL
+#define GPS_PROTOCOL            GPS_PROTOCOL_NMEA
+#endif
+
 // =============================
 // GPS Interface Definitions (Trimble 63530-00)
 // =============================
 
 // GPS data structure
 typedef struct {
-    float latitude;         // Decimal degrees
-    float longitude;        // Decimal degrees  
-    float altitude;         // Meters above sea level
+    int32_t latitude_e7;    // Fixed point, 1e-7 degrees (+N)
+    int32_t longitude_e7;   // Fixed point, 1e-7 degrees (+E)
+    int32_t altitude_cm;    // Centimetres above mean sea level
     uint8_t satellites;     // Number of satellites
     uint8_t fix_quality;    // GPS fix quality (0=none, 1=GPS, 2=DGPS)
     uint8_t valid;          // Data validity flag
@@ -6,15 +6,23 @@
 #include "includes.h"
 #include "system_definitions.h"
 #include "system_debug.h"
+#include "system_comms.h"
+#include "rf_interface.h"
 #include <libpic30.h>
 
-// Global system timer counter
-volatile uint32_t millis_counter = 0;
-static uint16_t timer_overflow_count = 0;
+// Microsecond time base (CCP2) - millisecond view extension across wraps
+static volatile uint32_t time_ms_base = 0;      // ms elapsed at the last wrap
+static volatile uint16_t time_ms_carry_us = 0;  // us past time_ms_base at the wrap
+static volatile uint16_t time_wrap_seq = 0;     // Bumped by each wrap
+
+// T.018 chip clock state (CCP1 ISR)
+volatile uint16_t chip_tick_count = 0;      // Chips elapsed (wraps, 16-bit atomic read)
+static uint16_t chip_phase_acc = 0;         // Fractional period accumulator (x CHIP_RATE_HZ)
 
 void oscillator_init(void);
 void ports_init(void);
 void timer_init(void);
+void timebase_init(void);
 void timer2_init_chip_clock(void);
 void uart_init(void);
 void uart2_init(void);
@@ -39,9 +47,10 @@ void timer2_init_chip_clock(void) {
     
     // Calculate compare value for 38.4 kHz
     // FCY = 100MHz, Target = 38.4kHz
-    // Period = FCY / Target = 100,000,000 / 38,400 = 2604.17 cycles
-    // Using 2604 gives 38.402kHz (error = +0.005%)
-    CCP1PRL = 2604 - 1;            // Set period for 38.4kHz
+    // Period = FCY / Target = 100,000,000 / 38,400 = 2604.1667 cycles
+    // A fixed 2604 gives 38.402kHz and drifts ~5 chips over a 76,800-chip burst,
+    // so the ISR alternates 2604/2605 (phase accumulator) for exactly 38.400 kHz
+    chip_clock_reset();            // First period + accumulator
     CCP1PRH = 0;                   // High word = 0 for 16-bit mode
     
     // Clear timer
@@ -53,8 +62,8 @@ void timer2_init_chip_clock(void) {
     IFS0bits.CCP1IF = 0;           // Clear interrupt flag
     IEC0bits.CCP1IE = 1;           // Enable CCP1 interrupt
     
-    // Enable CCP1 module
-    CCP1CON1Lbits.CCPON = 1;
+    // CCP1 stays off until start_chip_timer(): a 38.4 kHz ISR between bursts
+    // would wake the CPU from Idle every chip
     
     DEBUG_LOG_FLUSH("T.018 CCP1 chip clock initialized (38.400 kHz)\r\n");
 }
@@ -63,6 +72,7 @@ void timer2_init_chip_clock(void) {
 void system_init(void) {
     oscillator_init();
     ports_init();
+    timebase_init();
     timer_init();
     timer2_init_chip_clock();  // T.018 chip rate timer
     uart_init();
@@ -134,51 +144,155 @@ void ports_init(void) {
     CNPUCbits.CNPUC0 = 1;     // Enable pull-up (default = TEST mode)
 }
 
-// Timer1 initialization for system tick
+// Timer1 initialization - one-shot wake-up timer for cpu_idle_until_us()
+// (no periodic tick: time comes from the CCP2 time base)
 void timer_init(void) {
-    // Configure Timer1 for 1ms interrupts
-    T1CONbits.TON = 0;      // Disable timer
-    T1CONbits.TCKPS = 2;    // 1:64 prescaler
+    T1CONbits.TON = 0;      // Disable timer (armed per idle period)
+    T1CONbits.TCKPS = 3;    // 1:256 prescaler, 2.56 us per count
     T1CONbits.TCS = 0;      // Internal clock source
-    
-    // Set period for 1ms: FCY/64/1000 - 1
-    PR1 = (FCY/64/1000) - 1;
     TMR1 = 0;               // Clear counter
     
     // Configure interrupt
     IPC0bits.T1IP = 4;      // Interrupt priority 4
     IFS0bits.T1IF = 0;      // Clear interrupt flag
     IEC0bits.T1IE = 1;      // Enable interrupt
-    
-    T1CONbits.TON = 1;      // Start timer
 }
 
 // Timer2 initialization for T.018 chip clock (38.4 kHz)
 // Duplicate function removed - only one timer2_init_chip_clock needed
 
-// Timer1 interrupt service routine
+// Timer1 interrupt service routine - wake-up only, stop until re-armed
 void __attribute__((__interrupt__, __auto_psv__)) _T1Interrupt(void) {
-    millis_counter++;
-    timer_overflow_count++;
+    ISR_ENTER(ISR_ID_T1);
+    T1CONbits.TON = 0;
+    IFS0bits.T1IF = 0;  // Clear interrupt flag
+    ISR_EXIT();
+}
+
+// CCP2 as a free-running 32-bit timer clocked at 1 MHz from the reference
+// clock output: the timer itself is the microsecond counter (71.6 min wrap)
+void timebase_init(void) {
+    // REFO = FOSC / (2 x RODIV) = 200 MHz / 200 = 1 MHz, not routed to a pin
+    REFOCONLbits.ROEN = 0;
+    REFOCONLbits.ROSEL = 0;         // FOSC
+    REFOCONLbits.ROOUT = 0;
+    REFOCONHbits.RODIV = 100;
+    REFOCONLbits.ROEN = 1;
+    REFOCONLbits.ROSWEN = 1;        // Apply the divider
+    while(REFOCONLbits.ROSWEN);
+    
+    CCP2CON1Lbits.CCPON = 0;
+    CCP2CON1Lbits.MOD = 0b0000;     // Timer mode
+    CCP2CON1Lbits.T32 = 1;          // 32-bit timer
+    CCP2CON1Lbits.CLKSEL = 0b001;   // Reference clock (REFO)
+    CCP2CON1Lbits.TMRPS = 0;        // 1:1
+    CCP2PRL = 0xFFFF;               // Full 32-bit period
+    CCP2PRH = 0xFFFF;
+    CCP2TMRL = 0;
+    CCP2TMRH = 0;
+    
+    // Period (wrap) interrupt extends the millisecond view
+    IPC6bits.CCT2IP = 6;            // Above everything that reads the time
+    IFS1bits.CCT2IF = 0;
+    IEC1bits.CCT2IE = 1;
+    
+    CCP2CON1Lbits.CCPON = 1;
+}
+
+// One wrap is 2^32 us = 4294967 ms + 296 us
+static inline void time_apply_wrap(uint32_t* ms_base, uint16_t* carry_us) {
+    *ms_base += 4294967UL;
+    *carry_us += 296;
+    if(*carry_us >= 1000) {
+        *carry_us -= 1000;
+        (*ms_base)++;
+    }
+}
+
+// CCP2 wrap - once every 71.6 minutes
+void __attribute__((__interrupt__, __auto_psv__)) _CCT2Interrupt(void) {
+    ISR_ENTER(ISR_ID_CCT2);
+    uint32_t base = time_ms_base;
+    uint16_t carry = time_ms_carry_us;
+    time_apply_wrap(&base, &carry);
+    time_ms_base = base;
+    time_ms_carry_us = carry;
+    time_wrap_seq++;
+    
+    IFS1bits.CCT2IF = 0;
+    ISR_EXIT();
+}
+
+// Next chip period in FCY cycles (2604 or 2605) - phase accumulator, no division
+// Accumulates FCY % CHIP_RATE_HZ per chip and carries one cycle when it wraps,
+// i.e. exactly one long period every 6 chips
+static inline uint16_t chip_clock_next_period(uint16_t* phase_acc) {
+    *phase_acc += CHIP_PERIOD_FRAC;
+    if(*phase_acc >= CHIP_RATE_HZ) {
+        *phase_acc -= CHIP_RATE_HZ;
+        return CHIP_PERIOD_CYCLES + 1;
+    }
+    return CHIP_PERIOD_CYCLES;
+}
+
+// Restart the chip clock schedule (called before each burst)
+void chip_clock_reset(void) {
+    chip_phase_acc = 0;
+    chip_tick_count = 0;
+    CCP1PRL = chip_clock_next_period(&chip_phase_acc) - 1;
+}
+
+// Simulate the CCP1 period schedule over num_chips and return the accumulated
+// timing error in FCY cycles against the ideal 38.400 kHz chip grid
+int32_t chip_clock_burst_error(uint32_t num_chips) {
+    uint16_t phase_acc = 0;
+    uint32_t actual_cycles = 0;
+    
+    for(uint32_t i = 0; i < num_chips; i++) {
+        actual_cycles += chip_clock_next_period(&phase_acc);
+    }
     
-    // Toggle LED every 500ms for heartbeat
-    if((millis_counter % 500) == 0) {
-        LED_TOGGLE();
+    // Ideal elapsed time, rounded to the nearest cycle
+    uint32_t ideal_cycles = (uint32_t)(((uint64_t)num_chips * FCY + CHIP_RATE_HZ / 2) / CHIP_RATE_HZ);
+    
+    return (int32_t)(actual_cycles - ideal_cycles);
+}
+
+// Check the chip clock schedule over a full 300-bit burst
+uint8_t verify_chip_clock_schedule(void) {
+    int32_t error = chip_clock_burst_error(CHIPS_PER_BURST);
+    
+    DEBUG_LOG_FLUSH("Chip clock burst error (cycles): ");
+    if(error < 0) {
+        DEBUG_LOG_FLUSH("-");
+        debug_print_dec((uint32_t)(-error));
+    } else {
+        debug_print_dec((uint32_t)error);
     }
+    DEBUG_LOG_FLUSH("\r\n");
     
-    IFS0bits.T1IF = 0;  // Clear interrupt flag
+    // Within one cycle (10 ns) at the end of the burst
+    return (error >= -1 && error <= 1);
 }
 
 // CCP1 interrupt service routine - T.018 chip clock à 38.4 kHz précis
 void __attribute__((__interrupt__, __auto_psv__)) _CCP1Interrupt(void) {
-    // ISR appelée exactement à 38.400 kHz pour sortie chip T.018
-    // Gestion des symboles OQPSK avec timing hardware précis
+    // ISR appelée à chaque chip T.018 (38.400 kHz en moyenne)
+    ISR_ENTER(ISR_ID_CCP1);
+    
+    // The period register is reloaded for the period that has just started;
+    // ISR latency is far below the 2604-cycle period so the write always lands
+    CCP1PRL = chip_clock_next_period(&chip_phase_acc) - 1;
     
     // Signal disponible pour modules OQPSK/transmission
-    // Implémentation complète dans system_comms.c chip_timer callback
+    chip_tick_count++;
+    
+    // Next queued I/Q pair to the DAC, then any waiting synthesizer word
+    spi_service_chip_tick();
     
     // Clear CCP1 interrupt flag
     IFS0bits.CCP1IF = 0;
+    ISR_EXIT();
 }
 
 // UART initialization for debug output
@@ -191,6 +305,12 @@ void uart_init(void) {
     // Configure baud rate: FCY / (16 * (BRG + 1))
     U1BRG = (FCY / (16UL * BAUDRATE)) - 1;
     
+    // TX interrupt while the FIFO is empty; enabled on demand by the debug ring
+    U1STAHbits.UTXISEL = 0;
+    IPC3bits.U1TXIP = DEBUG_TX_ISR_IPL;
+    IFS0bits.U1TXIF = 0;
+    IEC0bits.U1TXIE = 0;
+    
     // Enable UART (T001 style)
     U1MODEbits.UARTEN = 1;  // Enable UART module
     U1MODEbits.UTXEN = 1;   // Enable transmitter
@@ -208,9 +328,21 @@ void uart2_init(void) {
     // Configure baud rate for GPS: FCY / (16 * (BRG + 1))
     U2BRG = (FCY / (16UL * GPS_BAUDRATE)) - 1;
     
+    #if GPS_PROTOCOL == GPS_PROTOCOL_TSIP
+    // TSIP ports default to 8 data bits, odd parity, 1 stop bit
+    U2MODEbits.MOD = 0b0010;
+    #endif
+    
+    // RX interrupt as soon as one byte is in the FIFO (drained into the GPS ring)
+    U2STAHbits.URXISEL = 0;
+    IPC7bits.U2RXIP = GPS_RX_ISR_IPL;
+    IFS1bits.U2RXIF = 0;
+    IEC1bits.U2RXIE = 1;
+    
     // Enable UART2 (T001 style)
     U2MODEbits.UARTEN = 1;    // Enable UART module
     U2MODEbits.UTXEN = 1;     // Enable transmitter
+    U2MODEbits.URXEN = 1;     // Enable receiver
 }
 
 // SPI initialization for dsPIC33CK (official datasheet DS70005399D)
@@ -299,13 +431,316 @@ void toggle_status_led(void) {
     LED_TOGGLE();
 }
 
+// Microseconds since boot (wraps every 71.6 min - compare with signed
+// differences). Re-read if the low word carried into the high word in between
+uint32_t get_system_time_us(void) {
+    uint16_t hi, lo;
+    do {
+        hi = CCP2TMRH;
+        lo = CCP2TMRL;
+    } while(hi != CCP2TMRH);
+    return ((uint32_t)hi << 16) | lo;
+}
+
+// floor(n / 1000) as a multiply-shift, exact for n < 4.9e9
+#define US_TO_MS_RECIP      274877907ULL    // ceil(2^38 / 1000)
+
+// Tickless millisecond view of the microsecond time base (wraps after 49 days)
 uint32_t get_system_time_ms(void) {
-    return millis_counter;
+    uint16_t seq;
+    uint32_t ms_base;
+    uint16_t carry_us;
+    uint32_t us;
+    
+    do {
+        seq = time_wrap_seq;
+        ms_base = time_ms_base;
+        carry_us = time_ms_carry_us;
+        us = get_system_time_us();
+    } while(seq != time_wrap_seq);
+    
+    // Wrapped but the CCT2 ISR is held off (caller at IPL >= 6)
+    if(IFS1bits.CCT2IF && us < 0x80000000UL) {
+        time_apply_wrap(&ms_base, &carry_us);
+    }
+    
+    return ms_base + (uint32_t)((((uint64_t)us + carry_us) * US_TO_MS_RECIP) >> 38);
 }
 
 void system_delay_ms(uint16_t ms) {
-    uint32_t start_time = millis_counter;
-    while((millis_counter - start_time) < ms) {
-        // Wait
+    uint32_t deadline_us = get_system_time_us() + (uint32_t)ms * 1000UL;
+    while((int32_t)(get_system_time_us() - deadline_us) < 0) {
+        cpu_idle_until_us(deadline_us);
+    }
+}
+
+// =============================================================================
+// PROGRAM FLASH
+// =============================================================================
+
+#define NVM_OP_DWORD_PROGRAM    0x4001      // WREN | double-word program
+#define NVM_OP_PAGE_ERASE       0x4003      // WREN | page erase
+#define NVM_WRITE_LATCH_PAGE    0x00FA      // TBLPAG of the write latches
+
+// Low 16 bits of the instruction word at addr
+uint16_t flash_read_word(uint32_t addr) {
+    uint16_t saved_tblpag = TBLPAG;
+    TBLPAG = (uint16_t)(addr >> 16);
+    uint16_t word = __builtin_tblrdl((uint16_t)addr);
+    TBLPAG = saved_tblpag;
+    return word;
+}
+
+// Upper 8 bits of the instruction word at addr
+uint8_t flash_read_high_byte(uint32_t addr) {
+    uint16_t saved_tblpag = TBLPAG;
+    TBLPAG = (uint16_t)(addr >> 16);
+    uint8_t high = (uint8_t)__builtin_tblrdh((uint16_t)addr);
+    TBLPAG = saved_tblpag;
+    return high;
+}
+
+// Start the NVM operation loaded in NVMCON and wait (the CPU stalls)
+static uint8_t flash_run_nvm_op(uint32_t addr) {
+    NVMADRU = (uint16_t)(addr >> 16);
+    NVMADR = (uint16_t)addr;
+    __builtin_write_NVM();          // Unlock sequence + WR, interrupts held off
+    while(NVMCONbits.WR);
+    NVMCONbits.WREN = 0;
+    return !NVMCONbits.WRERR;
+}
+
+// Program count words (even, addr on a double-word boundary), upper bytes 0
+uint8_t flash_write_words(uint32_t addr, const uint16_t* words, uint16_t count) {
+    uint16_t saved_tblpag = TBLPAG;
+    uint8_t ok = 1;
+    
+    for(uint16_t i = 0; i + 1 < count && ok; i += 2) {
+        NVMCON = NVM_OP_DWORD_PROGRAM;
+        TBLPAG = NVM_WRITE_LATCH_PAGE;
+        __builtin_tblwtl(0, words[i]);
+        __builtin_tblwth(0, 0x00);
+        __builtin_tblwtl(2, words[i + 1]);
+        __builtin_tblwth(2, 0x00);
+        ok = flash_run_nvm_op(addr + 2 * i);
+    }
+    
+    TBLPAG = saved_tblpag;
+    return ok;
+}
+
+uint8_t flash_erase_page(uint32_t addr) {
+    NVMCON = NVM_OP_PAGE_ERASE;
+    return flash_run_nvm_op(addr & ~(FLASH_PAGE_SIZE_ADDR - 1));
+}
+
+// =============================================================================
+// POWER MANAGEMENT
+// =============================================================================
+
+// Idle mode: the CPU clock stops, the PLL and all peripherals keep running.
+// Any enabled interrupt (Timer1 wake-up, GPS UART2 RX, debug UART1 TX) wakes
+// the core in a few cycles with no oscillator restart. Sleep is not used: it
+// stops the PLL (relock on every wake) and UART2 would lose GPS bytes
+static power_stats_t power_stats = {0};
+
+#define WAKE_TIMER_MAX_US   160000L     // Timer1 at 2.56 us/count spans 167 ms
+
+// Idle until deadline_us or any earlier interrupt. Returns at once when
+// less than two Timer1 counts (5 us) remain - the caller spins the rest
+void cpu_idle_until_us(uint32_t deadline_us) {
+    uint32_t t_start = get_system_time_us();
+    int32_t remaining_us = (int32_t)(deadline_us - t_start);
+    
+    if(remaining_us > WAKE_TIMER_MAX_US) {
+        remaining_us = WAKE_TIMER_MAX_US;
+    }
+    if(remaining_us < 6) {
+        return;
+    }
+    
+    // One-shot: match after PR1 + 1 counts, rounded down (never late)
+    T1CONbits.TON = 0;
+    TMR1 = 0;
+    PR1 = (uint16_t)(((uint32_t)remaining_us * 25) >> 6) - 1;
+    IFS0bits.T1IF = 0;
+    T1CONbits.TON = 1;
+    
+    Idle();
+    
+    power_stats.idle_us += get_system_time_us() - t_start;
+    power_stats.wakeups++;
+}
+
+const power_stats_t* get_power_stats(void) {
+    return &power_stats;
+}
+
+// =============================================================================
+// STACK USAGE
+// =============================================================================
+
+#define STACK_PAINT_WORD    0x5A5A
+#define STACK_PAINT_MARGIN  32          // Bytes left above the painter's own frame
+
+volatile uint8_t isr_nesting = 0;
+volatile uint8_t isr_nesting_max[ISR_NUM_IDS] = {0};
+volatile uint16_t isr_entry_depth_max = 0;
+
+#if defined(__XC16__) || defined(__XC_DSC__)
+// W15 traps (stack error) when it passes SPLIM, which the startup code loads
+// with __SPLIM_init. Everything between the painter's frame and the limit is
+// free at boot
+extern uint16_t __SPLIM_init;
+
+static uint16_t stack_size(void) {
+    return (uint16_t)((uintptr_t)&__SPLIM_init - (uintptr_t)&__SP_init);
+}
+
+// Call first thing in main(), before any interrupt is enabled
+void stack_paint(void) {
+    volatile uint16_t* p = (volatile uint16_t*)((STACK_POINTER() + STACK_PAINT_MARGIN) & ~1u);
+    volatile uint16_t* limit = (volatile uint16_t*)&__SPLIM_init;
+    
+    while(p <= limit) {
+        *p++ = STACK_PAINT_WORD;
+    }
+}
+
+// Deepest stack use since boot: scan down from the limit to the first word
+// that no longer holds the paint pattern
+uint16_t stack_high_water(void) {
+    const volatile uint16_t* p = (const volatile uint16_t*)&__SPLIM_init;
+    const volatile uint16_t* base = (const volatile uint16_t*)&__SP_init;
+    
+    while(p > base && *p == STACK_PAINT_WORD) {
+        p--;
+    }
+    return STACK_DEPTH((uintptr_t)(p + 1));
+}
+#else
+// Host build: no linker stack bounds to paint, so the high-water mark is the
+// deepest stack pointer sampled at ISR entry
+uintptr_t stack_host_base = 0;
+
+static uint16_t stack_size(void) {
+    return 0;
+}
+
+// Called first thing in main(), so this frame sits right below main()'s
+void stack_paint(void) {
+    stack_host_base = STACK_POINTER();
+}
+
+uint16_t stack_high_water(void) {
+    return isr_entry_depth_max;
+}
+#endif
+
+void get_stack_stats(stack_stats_t* stats) {
+    stats->size = stack_size();
+    stats->used = stack_high_water();
+    stats->isr_entry_max = isr_entry_depth_max;
+    for(uint8_t i = 0; i < ISR_NUM_IDS; i++) {
+        stats->nesting_max[i] = isr_nesting_max[i];
+    }
+}
+
+void stack_report(void) {
+    stack_stats_t stats;
+    get_stack_stats(&stats);
+    
+    DEBUG_EVENT3(MSG_STACK_USAGE, stats.used, stats.size, stats.isr_entry_max);
+    DEBUG_EVENT6(MSG_ISR_NESTING, stats.nesting_max[ISR_ID_CCP1], stats.nesting_max[ISR_ID_CCT2],
+                 stats.nesting_max[ISR_ID_T1], stats.nesting_max[ISR_ID_U2RX],
+                 stats.nesting_max[ISR_ID_U1TX], stats.nesting_max[ISR_ID_CNB]);
+}
+
+// =============================================================================
+// COOPERATIVE SCHEDULER
+// =============================================================================
+
+static sched_job_t sched_jobs[SCHED_NUM_JOBS];
+
+void sched_add_job(sched_job_id_t id, sched_job_fn_t fn, uint32_t deadline_us, uint32_t period_us) {
+    sched_job_t* job = &sched_jobs[id];
+    job->fn = fn;
+    job->deadline_us = deadline_us;
+    job->period_us = period_us;
+    job->runs = 0;
+    job->last_latency_us = 0;
+    job->max_latency_us = 0;
+    job->armed = 1;
+}
+
+void sched_set_deadline(sched_job_id_t id, uint32_t deadline_us) {
+    sched_jobs[id].deadline_us = deadline_us;
+    sched_jobs[id].armed = 1;
+}
+
+void sched_cancel(sched_job_id_t id) {
+    sched_jobs[id].armed = 0;
+}
+
+const sched_job_t* sched_get_job(sched_job_id_t id) {
+    return &sched_jobs[id];
+}
+
+// Earliest armed deadline, lowest ID first on ties (NULL if nothing armed)
+static sched_job_t* sched_next_job(void) {
+    sched_job_t* next = NULL;
+    for(uint8_t i = 0; i < SCHED_NUM_JOBS; i++) {
+        sched_job_t* job = &sched_jobs[i];
+        if(job->armed && (next == NULL ||
+           (int32_t)(job->deadline_us - next->deadline_us) < 0)) {
+            next = job;
+        }
+    }
+    return next;
+}
+
+// Dispatch loop, never returns. Waits for the earliest deadline, runs that
+// job to completion, then re-arms periodic jobs one period later (or one
+// period from now if the job fell behind, e.g. during a burst)
+void sched_run(void) {
+    while(1) {
+        sched_job_t* job = sched_next_job();
+        if(job == NULL) {
+            cpu_idle_until_us(get_system_time_us() + WAKE_TIMER_MAX_US);
+            continue;
+        }
+        
+        while((int32_t)(get_system_time_us() - job->deadline_us) < 0) {
+            cpu_idle_until_us(job->deadline_us);    // Wait for the deadline
+        }
+        
+        uint32_t latency_us = get_system_time_us() - job->deadline_us;
+        job->last_latency_us = latency_us;
+        if(latency_us > job->max_latency_us) {
+            job->max_latency_us = latency_us;
+        }
+        job->runs++;
+        
+        if(job->period_us == 0) {
+            job->armed = 0;     // One-shot: the job re-arms itself if needed
+        }
+        
+        job->fn();
+        
+        if(job->period_us != 0) {
+            uint32_t now = get_system_time_us();
+            job->deadline_us += job->period_us;
+            if((int32_t)(job->deadline_us - now) < 0) {
+                job->deadline_us = now + job->period_us;
+            }
+        }
+    }
+}
+
+void sched_print_stats(void) {
+    for(uint8_t i = 0; i < SCHED_NUM_JOBS; i++) {
+        uint32_t max_us = sched_jobs[i].max_latency_us;
+        DEBUG_EVENT4(MSG_SCHED_LATENCY, i, sched_jobs[i].runs,
+                     (uint16_t)max_us, (uint16_t)(max_us >> 16));
     }
 }
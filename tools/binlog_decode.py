@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Decode the T018 beacon binary debug log (DEBUG_OUTPUT_MODE = DEBUG_MODE_BINARY).
+
+The string table is built from system_debug_msgs.h, the same X-macro table the
+firmware is compiled with, so IDs and formats always match the build.
+
+Record layout (little endian):
+    0xA5 | id | nargs | timestamp_ms (u16) | nargs x u16
+
+Usage:
+    binlog_decode.py capture.bin                  # decode a raw UART capture
+    binlog_decode.py /dev/ttyUSB0 --serial        # live decode (needs pyserial)
+    binlog_decode.py --emit-table > strings.json  # dump the string table
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+MAX_ARGS = 6
+HEADER_LEN = 5
+
+DEFAULT_TABLE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                             '..', 'system_debug_msgs.h')
+
+MSG_RE = re.compile(r'^\s*DEBUG_MSG\(\s*(0x[0-9A-Fa-f]+|\d+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+SPEC_RE = re.compile(r'%(l?)u')
+
+
+def load_table(path):
+    """Parse system_debug_msgs.h into {id: (name, format, nwords)}."""
+    table = {}
+    with open(path, encoding='utf-8') as header:
+        for line in header:
+            match = MSG_RE.match(line)
+            if not match:
+                continue
+            msg_id = int(match.group(1), 0)
+            fmt = match.group(3)
+            nwords = sum(2 if long_spec else 1 for long_spec in SPEC_RE.findall(fmt))
+            table[msg_id] = (match.group(2), fmt, nwords)
+    return table
+
+
+def expand(fmt, words):
+    """Substitute %u (one word) and %lu (two words, low first) placeholders."""
+    values = iter(words)
+
+    def repl(match):
+        low = next(values, 0)
+        if match.group(1):
+            return str(low | (next(values, 0) << 16))
+        return str(low)
+
+    return SPEC_RE.sub(repl, fmt)
+
+
+class Decoder:
+    """Incremental record decoder with resynchronisation on the sync byte."""
+
+    def __init__(self, table):
+        self.table = table
+        self.buffer = bytearray()
+        self.time_base = 0
+        self.last_stamp = None
+        self.resyncs = 0
+
+    def _unwrap(self, stamp):
+        # 16-bit millisecond timestamps wrap every 65.5 s
+        if self.last_stamp is not None and stamp < self.last_stamp:
+            self.time_base += 0x10000
+        self.last_stamp = stamp
+        return self.time_base + stamp
+
+    def feed(self, data):
+        self.buffer.extend(data)
+        while True:
+            start = self.buffer.find(bytes([SYNC]))
+            if start < 0:
+                self.buffer.clear()
+                return
+            if start > 0:
+                self.resyncs += 1
+                del self.buffer[:start]
+            if len(self.buffer) < HEADER_LEN:
+                return
+            msg_id, nargs = self.buffer[1], self.buffer[2]
+            if nargs > MAX_ARGS or msg_id not in self.table:
+                self.resyncs += 1
+                del self.buffer[:1]
+                continue
+            length = HEADER_LEN + 2 * nargs
+            if len(self.buffer) < length:
+                return
+            stamp = struct.unpack_from('<H', self.buffer, 3)[0]
+            words = struct.unpack_from('<%dH' % nargs, self.buffer, HEADER_LEN)
+            del self.buffer[:length]
+            print(self._format(msg_id, stamp, words), flush=True)
+
+    def _format(self, msg_id, stamp, words):
+        name, fmt, nwords = self.table[msg_id]
+        text = expand(fmt, words)
+        if nwords != len(words):
+            text += '  [expected %d words, got %d]' % (nwords, len(words))
+        return '%10.3f  %-16s %s' % (self._unwrap(stamp) / 1000.0, name, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('source', nargs='?', help='capture file or serial port')
+    parser.add_argument('--table', default=DEFAULT_TABLE, help='path to system_debug_msgs.h')
+    parser.add_argument('--serial', action='store_true', help='read SOURCE as a serial port')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--emit-table', action='store_true', help='print the string table as JSON')
+    args = parser.parse_args()
+
+    table = load_table(args.table)
+
+    if args.emit_table:
+        json.dump({'0x%02X' % k: {'name': v[0], 'format': v[1], 'words': v[2]}
+                   for k, v in sorted(table.items())}, sys.stdout, indent=2)
+        print()
+        return 0
+
+    if not args.source:
+        parser.error('SOURCE is required unless --emit-table is given')
+
+    decoder = Decoder(table)
+    if args.serial:
+        import serial  # pyserial
+        with serial.Serial(args.source, args.baud, timeout=0.1) as port:
+            while True:
+                decoder.feed(port.read(256))
+    else:
+        with open(args.source, 'rb') as capture:
+            decoder.feed(capture.read())
+
+    if decoder.resyncs:
+        print('(%d resynchronisations)' % decoder.resyncs, file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,96 @@
+/* flash_sim.c
+ * T018 host tests - program flash simulator (see flash_sim.h)
+ *
+ * Flash cells only go from 1 to 0 when programmed; an erase sets a whole
+ * page back to 0xFFFF. The dsPIC programs double words, and programming a
+ * double word that is not erased is not allowed (ECC), so the simulator
+ * counts it instead of refusing, letting tests assert it never happens.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flash_sim.h"
+#include "system_definitions.h"
+
+#define FLASH_SIM_WORDS     (FLASH_PROGRAM_END_ADDR / 2)
+#define FAULT_NONE          (~0UL)
+
+flash_sim_stats_t flash_sim_stats;
+
+static uint16_t flash_words[FLASH_SIM_WORDS];
+static uint8_t flash_high[FLASH_SIM_WORDS];       // Upper 8 bits of each word
+static unsigned long fail_at = FAULT_NONE;
+static unsigned long weak_at = FAULT_NONE;
+
+void flash_sim_reset(void) {
+    memset(flash_words, 0xFF, sizeof(flash_words));
+    memset(flash_high, 0xFF, sizeof(flash_high));
+    memset(&flash_sim_stats, 0, sizeof(flash_sim_stats));
+    fail_at = FAULT_NONE;
+    weak_at = FAULT_NONE;
+}
+
+void flash_sim_fail_program(unsigned long after) {
+    fail_at = flash_sim_stats.programs + after;
+}
+
+void flash_sim_weak_program(unsigned long after) {
+    weak_at = flash_sim_stats.programs + after;
+}
+
+static uint32_t flash_sim_index(uint32_t addr) {
+    if(addr >= FLASH_PROGRAM_END_ADDR || (addr & 1)) {
+        printf("flash_sim: bad address 0x%05lX\n", (unsigned long)addr);
+        exit(2);
+    }
+    return addr / 2;
+}
+
+uint16_t* flash_sim_word(uint32_t addr) {
+    return &flash_words[flash_sim_index(addr)];
+}
+
+uint8_t* flash_sim_high_byte(uint32_t addr) {
+    return &flash_high[flash_sim_index(addr)];
+}
+
+uint16_t __wrap_flash_read_word(uint32_t addr) {
+    return *flash_sim_word(addr);
+}
+
+uint8_t __wrap_flash_read_high_byte(uint32_t addr) {
+    return *flash_sim_high_byte(addr);
+}
+
+uint8_t __wrap_flash_write_words(uint32_t addr, const uint16_t* words, uint16_t count) {
+    for(uint16_t i = 0; i + 1 < count; i += 2) {
+        unsigned long n = flash_sim_stats.programs++;
+        uint16_t* cell = flash_sim_word(addr + 2 * i);
+
+        if(n == fail_at) {
+            return 0;
+        }
+        if(cell[0] != FLASH_ERASED_WORD || cell[1] != FLASH_ERASED_WORD) {
+            flash_sim_stats.overprograms++;
+        }
+        cell[0] &= words[i];
+        cell[1] &= words[i + 1];
+        *flash_sim_high_byte(addr + 2 * i) = 0x00;      // Upper bytes written as 0
+        *flash_sim_high_byte(addr + 2 * i + 2) = 0x00;
+        if(n == weak_at) {
+            cell[0] |= 0x0001;
+        }
+    }
+    return 1;
+}
+
+uint8_t __wrap_flash_erase_page(uint32_t addr) {
+    addr &= ~(FLASH_PAGE_SIZE_ADDR - 1);
+    flash_sim_stats.erases++;
+    for(uint32_t a = addr; a < addr + FLASH_PAGE_SIZE_ADDR; a += 2) {
+        *flash_sim_word(a) = FLASH_ERASED_WORD;
+        *flash_sim_high_byte(a) = 0xFF;
+    }
+    return 1;
+}
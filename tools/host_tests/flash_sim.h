@@ -0,0 +1,35 @@
+/* flash_sim.h
+ * T018 host tests - program flash simulator behind flash_read_word(),
+ * flash_read_high_byte(), flash_write_words() and flash_erase_page()
+ * (linked with -Wl,--wrap), over the whole user flash
+ */
+
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+
+// Operation counters since the last flash_sim_reset()
+typedef struct {
+    unsigned long programs;         // Double-word programs attempted
+    unsigned long erases;           // Page erases
+    unsigned long overprograms;     // Programs onto a non-erased double word
+} flash_sim_stats_t;
+
+extern flash_sim_stats_t flash_sim_stats;
+
+// Whole array erased, faults disarmed, counters cleared
+void flash_sim_reset(void);
+
+// Fault injection, counted in double-word programs from now (0 = the next
+// one). A failed program writes nothing and reports WRERR; a weak program
+// reports success but leaves bit 0 of the first word erased, so only a
+// read-back catches it
+void flash_sim_fail_program(unsigned long after);
+void flash_sim_weak_program(unsigned long after);
+
+// Direct access to the low 16 bits / upper 8 bits of the word at addr
+uint16_t* flash_sim_word(uint32_t addr);
+uint8_t* flash_sim_high_byte(uint32_t addr);
+
+#endif /* FLASH_SIM_H */
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Generate the host stand-ins for <xc.h> / <libpic30.h> used by the host tests.
+
+The firmware sources are compiled unchanged with the host gcc. Every special
+function register they touch (FOOxbits.FIELD or a bare upper-case register
+name) becomes a plain RAM variable, and the XC-DSC builtins become no-ops, so
+the pure logic (parsers, encoders, frame builder, config store) runs on the
+PC. The SPI1 status flags and Idle() go to spi_sim.c instead, so transfers
+are recorded and a test can stand in for the interrupt that ends an Idle().
+
+Usage:
+    gen_xc.py <firmware dir> <output dir>
+
+Writes <output dir>/include/xc.h, <output dir>/include/libpic30.h and
+<output dir>/sfr.c (the register definitions).
+"""
+
+import glob
+import os
+import re
+import sys
+
+# XC-DSC builtins and macros used by the firmware, as host no-ops
+BUILTINS = [
+    '#define __prog__',
+    '#define Nop() ((void)0)',
+    'void host_idle(void);',
+    '#define Idle() host_idle()',
+    '#define Sleep() ((void)0)',
+    '#define ClrWdt() ((void)0)',
+    '#define __builtin_nop() ((void)0)',
+    '#define __delay_us(x) ((void)0)',
+    '#define __delay_ms(x) ((void)0)',
+    '#define __builtin_disable_interrupts() ((void)0)',
+    '#define __builtin_enable_interrupts() ((void)0)',
+    '#define __builtin_write_OSCCONH(x) ((void)(x))',
+    '#define __builtin_write_OSCCONL(x) ((void)(x))',
+    '#define __builtin_write_NVM() ((void)0)',
+    '#define __builtin_tblpage(x) 0',
+    '#define __builtin_tbloffset(x) 0',
+    '#define __builtin_tblrdl(x) ((uint16_t)0xFFFF)',
+    '#define __builtin_tblrdh(x) ((uint16_t)0x00FF)',
+    '#define __builtin_tblwtl(a, b) ((void)(b))',
+    '#define __builtin_tblwth(a, b) ((void)(b))',
+    '#define __builtin_mulss(a, b) ((int32_t)(a) * (b))',
+    '#define __builtin_muluu(a, b) ((uint32_t)(a) * (b))',
+    '#define __builtin_divud(a, b) ((uint16_t)((a) / (b)))',
+    '#define SET_AND_SAVE_CPU_IPL(save, ipl) ((save) = 0)',
+    '#define RESTORE_CPU_IPL(save) ((void)(save))',
+    '#define SET_CPU_IPL(ipl) ((void)0)',
+]
+
+# Registers read through a simulator (spi_sim.c) instead of plain RAM
+SFR_HOOKS = {'SPI1STATL': 'host_spi1_statl'}
+
+BITS_RE = re.compile(r'\b(\w+)bits\.(\w+)')
+# Bare registers: CCP1PRL, U2RXREG, TBLPAG, _U2RXR, _RP52R ...
+REG_RE = re.compile(r'(?<![\w.])([A-Z][A-Z0-9]*[0-9][A-Z0-9]*|[A-Z]{3,}|_[A-Z]+[0-9]+R|_[A-Z][0-9A-Z]*R)\b(?!\s*\()')
+# Upper-case names that come from the C library, not the device
+C_NAMES = {'NULL', 'EOF', 'FILE'}
+# Registers the firmware declares itself keep the firmware's type
+SFR_DECL_RE = re.compile(r'extern\s+volatile\s+([\w ]+?)\s+__attribute__\(\(__sfr__\)\)\s+(\w+)\s*;')
+DEFINE_RE = re.compile(r'^\s*#\s*define\s+(\w+)', re.M)
+ENUM_RE = re.compile(r'\benum\b[^{;]*\{([^}]*)\}')
+ENUMERATOR_RE = re.compile(r'(?:^|,)\s*([A-Za-z_]\w*)')
+# Comments, string/char literals and #pragma config lines are not code
+COMMENT_RE = re.compile(r'//[^\n]*|/\*.*?\*/|"(?:[^"\\\n]|\\.)*"|\'(?:[^\'\\\n]|\\.)*\'|^\s*#\s*pragma[^\n]*', re.S | re.M)
+
+
+def scan(src_dir):
+    code = ''
+    for path in sorted(glob.glob(os.path.join(src_dir, '*.[ch]'))):
+        with open(path, encoding='latin-1') as f:
+            code += COMMENT_RE.sub(' ', f.read()) + '\n'
+
+    bits = {}
+    for m in BITS_RE.finditer(code):
+        bits.setdefault(m.group(1), set()).add(m.group(2))
+
+    # Anything the firmware defines itself is not a register
+    own = set(DEFINE_RE.findall(code))
+    for body in ENUM_RE.findall(code):
+        own |= set(ENUMERATOR_RE.findall(body))
+    regs = set(REG_RE.findall(code)) - own - set(bits)
+    regs = {r for r in regs if not r.endswith('_t') and r not in C_NAMES}
+    for name in bits:
+        regs.add(name)          # FOObits implies the FOO word register
+    types = {name: ctype for ctype, name in SFR_DECL_RE.findall(code)}
+    return bits, [(name, types.get(name, 'uint16_t')) for name in sorted(regs)]
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    src_dir, out_dir = sys.argv[1], sys.argv[2]
+    os.makedirs(os.path.join(out_dir, 'include'), exist_ok=True)
+    bits, regs = scan(src_dir)
+
+    xc = ['/* Generated by gen_xc.py - host stand-in for the XC-DSC device header */',
+          '#ifndef HOST_XC_H', '#define HOST_XC_H', '', '#include <stdint.h>', '']
+    xc += BUILTINS + ['']
+    for name in sorted(bits):
+        fields = ' '.join('unsigned %s : 8;' % f for f in sorted(bits[name]))
+        xc.append('typedef struct { %s } %sBITS;' % (fields, name))
+        if name in SFR_HOOKS:
+            xc.append('volatile %sBITS* %s(void);' % (name, SFR_HOOKS[name]))
+            xc.append('#define %sbits (*%s())' % (name, SFR_HOOKS[name]))
+        else:
+            xc.append('extern volatile %sBITS %sbits;' % (name, name))
+    for name, ctype in regs:
+        xc.append('extern volatile %s %s;' % (ctype, name))
+    xc += ['', '#endif']
+
+    sfr = ['/* Generated by gen_xc.py - host RAM behind every register */',
+           '#include <xc.h>', '']
+    sfr += ['volatile %sBITS %sbits;' % (n, n) for n in sorted(bits) if n not in SFR_HOOKS]
+    sfr += ['volatile %s %s;' % (t, n) for n, t in regs]
+
+    with open(os.path.join(out_dir, 'include', 'xc.h'), 'w') as f:
+        f.write('\n'.join(xc) + '\n')
+    with open(os.path.join(out_dir, 'include', 'libpic30.h'), 'w') as f:
+        f.write('/* Generated by gen_xc.py - nothing needed on the host */\n')
+    with open(os.path.join(out_dir, 'sfr.c'), 'w') as f:
+        f.write('\n'.join(sfr) + '\n')
+
+
+if __name__ == '__main__':
+    main()
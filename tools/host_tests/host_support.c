@@ -0,0 +1,21 @@
+/* host_support.c
+ * T018 host tests - check/report helpers shared by every test program
+ */
+
+#include <time.h>
+#include "host_support.h"
+
+unsigned long host_checks = 0;
+unsigned long host_failures = 0;
+
+int host_report(const char* name) {
+    printf("%s: %lu checks, %lu failed - %s\n", name, host_checks, host_failures,
+           host_failures ? "FAIL" : "PASS");
+    return host_failures ? 1 : 0;
+}
+
+double host_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
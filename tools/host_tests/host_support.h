@@ -0,0 +1,47 @@
+/* host_support.h
+ * T018 host tests - check/report helpers shared by every test program
+ * Firmware modules are compiled unchanged against the generated xc.h stand-in
+ */
+
+#ifndef HOST_SUPPORT_H
+#define HOST_SUPPORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// =============================================================================
+// CHECKS
+// =============================================================================
+
+extern unsigned long host_checks;
+extern unsigned long host_failures;
+
+#define CHECK(cond) do { \
+    host_checks++; \
+    if(!(cond)) { \
+        host_failures++; \
+        printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+} while(0)
+
+#define CHECK_EQ(actual, expected) do { \
+    long long a_ = (long long)(actual), e_ = (long long)(expected); \
+    host_checks++; \
+    if(a_ != e_) { \
+        host_failures++; \
+        printf("%s:%d: CHECK_EQ failed: %s = %lld, expected %lld\n", \
+               __FILE__, __LINE__, #actual, a_, e_); \
+    } \
+} while(0)
+
+// Print the summary line and return the process exit code
+int host_report(const char* name);
+
+// =============================================================================
+// TIMING
+// =============================================================================
+
+// Monotonic wall clock in seconds
+double host_seconds(void);
+
+#endif /* HOST_SUPPORT_H */
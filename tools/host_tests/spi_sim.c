@@ -0,0 +1,69 @@
+/* spi_sim.c
+ * T018 host tests - SPI1 simulator (see spi_sim.h)
+ *
+ * spi_transfer_16() polls SPITBF once before writing SPI1BUFL and SPIRBF
+ * once after, so reads of the status register alternate: the first of each
+ * pair reports an empty transmit buffer, the second logs the word and
+ * reports it received.
+ */
+
+#include <string.h>
+#include "spi_sim.h"
+#include "system_definitions.h"
+#include "rf_interface.h"
+
+spi_sim_word_t spi_sim_log[SPI_SIM_LOG_SIZE];
+spi_sim_stats_t spi_sim_stats;
+
+static SPI1STATLBITS spi1_statl;
+static uint8_t spi1_polls;
+static void (*idle_hook)(void);
+
+void spi_sim_reset(void) {
+    memset(spi_sim_log, 0, sizeof(spi_sim_log));
+    memset(&spi_sim_stats, 0, sizeof(spi_sim_stats));
+    spi1_polls = 0;
+    idle_hook = NULL;
+    spi_select_device(SPI_DEVICE_NONE);
+}
+
+void spi_sim_set_idle_hook(void (*hook)(void)) {
+    idle_hook = hook;
+}
+
+static uint8_t spi_sim_selected(void) {
+    uint8_t device = SPI_DEVICE_NONE;
+    uint8_t low = 0;
+    
+    if(!ADF_CS_LAT) { device = SPI_DEVICE_ADF7012; low++; }
+    if(!MCP4922_CS_LAT) { device = SPI_DEVICE_MCP4922; low++; }
+    if(!ADF4351_CS_LAT) { device = SPI_DEVICE_ADF4351; low++; }
+    if(low > 1) {
+        spi_sim_stats.cs_conflicts++;
+    }
+    return device;
+}
+
+volatile SPI1STATLBITS* host_spi1_statl(void) {
+    if(spi1_polls++ & 1) {
+        uint8_t device = spi_sim_selected();
+        if(spi_sim_stats.words < SPI_SIM_LOG_SIZE) {
+            spi_sim_log[spi_sim_stats.words].device = device;
+            spi_sim_log[spi_sim_stats.words].word = SPI1BUFL;
+        }
+        spi_sim_stats.words++;
+        spi1_statl.SPITBF = 0;
+        spi1_statl.SPIRBF = 1;
+    } else {
+        spi1_statl.SPITBF = 0;
+        spi1_statl.SPIRBF = 0;
+    }
+    return &spi1_statl;
+}
+
+void host_idle(void) {
+    spi_sim_stats.idles++;
+    if(idle_hook) {
+        idle_hook();
+    }
+}
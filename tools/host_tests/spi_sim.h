@@ -0,0 +1,35 @@
+/* spi_sim.h
+ * T018 host tests - SPI1 simulator behind SPI1STATLbits (see gen_xc.py):
+ * every word spi_transfer_16() shifts out is logged with the chip select
+ * that was low. Idle() calls a hook the test sets, standing in for the
+ * interrupt that would wake the CPU
+ */
+
+#ifndef SPI_SIM_H
+#define SPI_SIM_H
+
+#include <stdint.h>
+
+#define SPI_SIM_LOG_SIZE        1024    // Words kept; later ones are only counted
+
+typedef struct {
+    uint8_t device;             // spi_device_t, SPI_DEVICE_NONE if no CS was low
+    uint16_t word;
+} spi_sim_word_t;
+
+typedef struct {
+    unsigned long words;        // Words shifted out
+    unsigned long cs_conflicts; // Words with more than one chip select low
+    unsigned long idles;        // Idle() calls
+} spi_sim_stats_t;
+
+extern spi_sim_word_t spi_sim_log[SPI_SIM_LOG_SIZE];
+extern spi_sim_stats_t spi_sim_stats;
+
+// Log and counters cleared, every chip select high, no idle hook
+void spi_sim_reset(void);
+
+// Run by each Idle() (NULL: Idle() returns at once)
+void spi_sim_set_idle_hook(void (*hook)(void));
+
+#endif /* SPI_SIM_H */
@@ -0,0 +1,124 @@
+/* test_adf7012_shadow.c
+ * ADF7012 register shadow: values equal to the latched ones are skipped, a
+ * value staged again before the commit replaces the pending one, words go
+ * out REG3, REG0, REG1, REG2, the commit result flags only the synthesizer
+ * registers, and during a burst the words are queued for the chip gaps
+ */
+
+#include "host_support.h"
+#include "spi_sim.h"
+#include "system_definitions.h"
+#include "rf_interface.h"
+
+#define REG0_VALUE          0x200008UL
+#define REG1_VALUE          0x654320UL
+#define REG2_VALUE          (ADF7012_REG2_INIT & ~ADF7012_REG2_RF_ENABLE)
+#define REG3_VALUE          0x0C01C4UL
+
+static void check_reg_word(unsigned long index, uint8_t reg, uint32_t value) {
+    uint32_t word = (value & 0xFFFFFC) | reg;
+
+    CHECK_EQ(spi_sim_log[index].device, SPI_DEVICE_ADF7012);
+    CHECK_EQ(spi_sim_log[index].word, (uint16_t)(word >> 16));
+    CHECK_EQ(spi_sim_log[index + 1].device, SPI_DEVICE_ADF7012);
+    CHECK_EQ(spi_sim_log[index + 1].word, (uint16_t)word);
+}
+
+static void stage_all(void) {
+    adf7012_stage_register(ADF7012_REG2, REG2_VALUE);
+    adf7012_stage_register(ADF7012_REG1, REG1_VALUE);
+    adf7012_stage_register(ADF7012_REG0, REG0_VALUE);
+    adf7012_stage_register(ADF7012_REG3, REG3_VALUE);
+}
+
+// First commit after power-up: every register, in initialization order
+static void test_full_commit(void) {
+    const adf7012_shadow_t* shadow = adf7012_get_shadow();
+
+    spi_sim_reset();
+    stage_all();
+    CHECK_EQ(shadow->dirty, 0x0F);
+    CHECK_EQ(adf7012_commit(), (1 << ADF7012_REG0) | (1 << ADF7012_REG1) | (1 << ADF7012_REG3));
+
+    CHECK_EQ(spi_sim_stats.words, 8);
+    check_reg_word(0, ADF7012_REG3, REG3_VALUE);
+    check_reg_word(2, ADF7012_REG0, REG0_VALUE);
+    check_reg_word(4, ADF7012_REG1, REG1_VALUE);
+    check_reg_word(6, ADF7012_REG2, REG2_VALUE);
+    CHECK_EQ(spi_sim_stats.cs_conflicts, 0);
+    CHECK_EQ(shadow->valid, 0x0F);
+    CHECK_EQ(shadow->dirty, 0);
+    CHECK_EQ(shadow->words_written, 4);
+}
+
+// Same values again: nothing staged, nothing written
+static void test_skip_equal(void) {
+    const adf7012_shadow_t* shadow = adf7012_get_shadow();
+    uint16_t skipped = shadow->writes_skipped;
+
+    spi_sim_reset();
+    stage_all();
+    CHECK_EQ(shadow->writes_skipped - skipped, 4);
+    CHECK_EQ(shadow->dirty, 0);
+    CHECK_EQ(adf7012_commit(), 0);
+    CHECK_EQ(spi_sim_stats.words, 0);
+
+    // The two low bits are the address, not part of the value
+    adf7012_stage_register(ADF7012_REG1, REG1_VALUE | 0x3);
+    CHECK_EQ(shadow->dirty, 0);
+}
+
+// Only REG2 changed: written, but no relock needed
+static void test_function_register(void) {
+    spi_sim_reset();
+    adf7012_enable_output(1);
+    CHECK_EQ(spi_sim_stats.words, 2);
+    check_reg_word(0, ADF7012_REG2, REG2_VALUE | ADF7012_REG2_RF_ENABLE);
+
+    spi_sim_reset();
+    adf7012_stage_register(ADF7012_REG2, REG2_VALUE);
+    CHECK_EQ(adf7012_commit(), 0);
+    CHECK_EQ(spi_sim_stats.words, 2);
+}
+
+// A value staged over a pending one wins, even when it equals the shadow
+static void test_restage(void) {
+    const adf7012_shadow_t* shadow = adf7012_get_shadow();
+
+    spi_sim_reset();
+    adf7012_stage_register(ADF7012_REG1, REG1_VALUE + 0x40);
+    adf7012_stage_register(ADF7012_REG1, REG1_VALUE);
+    CHECK_EQ(shadow->dirty, 1 << ADF7012_REG1);
+    CHECK_EQ(adf7012_commit(), 1 << ADF7012_REG1);
+    CHECK_EQ(spi_sim_stats.words, 2);
+    check_reg_word(0, ADF7012_REG1, REG1_VALUE);
+}
+
+// Burst on air: queued as background words, one per chip gap, same order
+static void test_streaming(void) {
+    spi_sim_reset();
+    spi_stream_start();
+    adf7012_stage_register(ADF7012_REG0, REG0_VALUE + 0x40);
+    adf7012_stage_register(ADF7012_REG3, REG3_VALUE ^ ADF7012_REG3_PLL_ENABLE);
+    CHECK_EQ(adf7012_commit(), (1 << ADF7012_REG0) | (1 << ADF7012_REG3));
+    CHECK_EQ(spi_sim_stats.words, 0);
+
+    spi_service_chip_tick();
+    CHECK_EQ(spi_sim_stats.words, 2);
+    spi_service_chip_tick();
+    CHECK_EQ(spi_sim_stats.words, 4);
+    check_reg_word(0, ADF7012_REG3, REG3_VALUE ^ ADF7012_REG3_PLL_ENABLE);
+    check_reg_word(2, ADF7012_REG0, REG0_VALUE + 0x40);
+    CHECK_EQ(spi_get_sched_stats()->bg_completed, 2);
+    spi_stream_stop();
+    CHECK_EQ(spi_sim_stats.words, 4);
+}
+
+int main(void) {
+    test_full_commit();
+    test_skip_equal();
+    test_function_register();
+    test_restage();
+    test_streaming();
+    return host_report("test_adf7012_shadow");
+}
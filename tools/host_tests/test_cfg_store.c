@@ -0,0 +1,161 @@
+/* test_cfg_store.c
+ * Flash configuration log on the flash simulator: append/read, reboot
+ * recovery, page rotation, failed and unverified writes, reset mid-rotation
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "flash_sim.h"
+#include "protocol_data.h"
+
+static void make_payload(uint16_t* payload, uint16_t seed) {
+    for(uint8_t i = 0; i < CFG_RECORD_PAYLOAD_WORDS; i++) {
+        payload[i] = (uint16_t)(seed * 31u + i);
+    }
+}
+
+static uint8_t read_matches(cfg_record_type_t type, uint16_t seed) {
+    uint16_t expected[CFG_RECORD_PAYLOAD_WORDS];
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    make_payload(expected, seed);
+    return cfg_store_read(type, payload) && memcmp(payload, expected, sizeof(payload)) == 0;
+}
+
+static uint8_t write_seed(cfg_record_type_t type, uint16_t seed) {
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+    make_payload(payload, seed);
+    return cfg_store_write(type, payload);
+}
+
+static void test_blank_and_append(void) {
+    uint16_t payload[CFG_RECORD_PAYLOAD_WORDS];
+
+    flash_sim_reset();
+    CHECK_EQ(cfg_store_init(), 1);
+    CHECK_EQ(flash_sim_stats.erases, 1);            // Page 0 formatted
+    CHECK_EQ(cfg_store_read(CFG_TYPE_BEACON, payload), 0);
+
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 1), 1);
+    CHECK_EQ(write_seed(CFG_TYPE_POST, 2), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 1));
+    CHECK(read_matches(CFG_TYPE_POST, 2));
+
+    // Identical record: nothing programmed
+    unsigned long programs = flash_sim_stats.programs;
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 1), 1);
+    CHECK_EQ(flash_sim_stats.programs, programs);
+
+    // Reboot: the log and the append point are recovered from flash
+    CHECK_EQ(cfg_store_init(), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 1));
+    CHECK(read_matches(CFG_TYPE_POST, 2));
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 3), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 3));
+    CHECK_EQ(flash_sim_stats.overprograms, 0);
+}
+
+// Many updates with reboots in between: rotates through both pages
+static void test_rotation(void) {
+    flash_sim_reset();
+    CHECK_EQ(cfg_store_init(), 1);
+    CHECK_EQ(write_seed(CFG_TYPE_POST, 1000), 1);
+
+    for(uint16_t seed = 1; seed <= 4 * CFG_SLOTS_PER_PAGE; seed++) {
+        CHECK_EQ(write_seed(CFG_TYPE_BEACON, seed), 1);
+        if(seed % 37 == 0) {
+            CHECK_EQ(cfg_store_init(), 1);
+        }
+        CHECK(read_matches(CFG_TYPE_BEACON, seed));
+    }
+    CHECK(read_matches(CFG_TYPE_POST, 1000));      // Carried over every rotation
+    CHECK(flash_sim_stats.erases >= 4);
+    CHECK_EQ(flash_sim_stats.overprograms, 0);
+}
+
+// A write that fails before touching the slot retries the same slot; one
+// that programmed the slot but failed verification steps over it
+static void test_failed_writes(void) {
+    flash_sim_reset();
+    CHECK_EQ(cfg_store_init(), 1);
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 1), 1);
+
+    unsigned long programs = flash_sim_stats.programs;
+    flash_sim_fail_program(0);
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 2), 0);
+    CHECK(read_matches(CFG_TYPE_BEACON, 1));
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 2), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 2));
+
+    // Retried in place: both attempts programmed the same first double word
+    uint32_t slot2 = CFG_STORE_PAGE0_ADDR + 2 * 2 * CFG_RECORD_WORDS;
+    CHECK_EQ(*flash_sim_word(slot2), CFG_RECORD_MAGIC | CFG_TYPE_BEACON);
+    CHECK_EQ(*flash_sim_word(slot2 + 2 * CFG_RECORD_WORDS), FLASH_ERASED_WORD);
+    CHECK_EQ(flash_sim_stats.programs - programs, 1 + CFG_RECORD_WORDS / 2);
+
+    // Torn write: first double word programmed, second one fails
+    flash_sim_fail_program(1);
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 3), 0);
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 4), 1);
+
+    // Programmed but wrong on read-back
+    flash_sim_weak_program(0);
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 5), 0);
+    CHECK(read_matches(CFG_TYPE_BEACON, 4));
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 6), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 6));
+    CHECK_EQ(flash_sim_stats.overprograms, 0);
+
+    // Reboot skips the damaged slots and still appends after them
+    CHECK_EQ(cfg_store_init(), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 6));
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, 7), 1);
+    CHECK(read_matches(CFG_TYPE_BEACON, 7));
+    CHECK_EQ(flash_sim_stats.overprograms, 0);
+}
+
+// Blank store, one POST record, then BEACON records up to a full page.
+// Returns the last BEACON seed written
+static uint16_t fill_first_page(void) {
+    uint16_t last = CFG_SLOTS_PER_PAGE - 2;     // Slot 0 header, slot 1 POST
+
+    flash_sim_reset();
+    CHECK_EQ(cfg_store_init(), 1);
+    CHECK_EQ(write_seed(CFG_TYPE_POST, 500), 1);
+    for(uint16_t seed = 1; seed <= last; seed++) {
+        CHECK_EQ(write_seed(CFG_TYPE_BEACON, seed), 1);
+    }
+    CHECK(read_matches(CFG_TYPE_BEACON, last));
+    return last;
+}
+
+// Reset at every program of a page rotation: the old page stays newest
+// until the new header is written, so the last committed record survives
+static void test_reset_during_rotation(void) {
+    uint16_t last = fill_first_page();
+    unsigned long before = flash_sim_stats.programs;
+    CHECK_EQ(write_seed(CFG_TYPE_BEACON, last + 1), 1);
+    unsigned long rotation_programs = flash_sim_stats.programs - before;
+    CHECK(rotation_programs > 0);
+
+    for(unsigned long cut = 0; cut < rotation_programs; cut++) {
+        last = fill_first_page();
+        flash_sim_fail_program(cut);
+        CHECK_EQ(write_seed(CFG_TYPE_BEACON, last + 1), 0);
+
+        CHECK_EQ(cfg_store_init(), 1);
+        CHECK(read_matches(CFG_TYPE_BEACON, last));
+        CHECK(read_matches(CFG_TYPE_POST, 500));
+        CHECK_EQ(write_seed(CFG_TYPE_BEACON, 9999), 1);
+        CHECK(read_matches(CFG_TYPE_BEACON, 9999));
+        CHECK(read_matches(CFG_TYPE_POST, 500));
+        CHECK_EQ(flash_sim_stats.overprograms, 0);
+    }
+}
+
+int main(void) {
+    test_blank_and_append();
+    test_rotation();
+    test_failed_writes();
+    test_reset_during_rotation();
+    return host_report("test_cfg_store");
+}
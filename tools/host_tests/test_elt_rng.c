@@ -0,0 +1,170 @@
+/* test_elt_rng.c
+ * Phase 3 interval dither over millions of draws: every value of the span
+ * (chi-square), consecutive pairs, bounds and mean, replay after reseed,
+ * no lock-step between neighbouring serials, and the cost per draw
+ */
+
+#include <math.h>
+#include <string.h>
+#include "host_support.h"
+#include "protocol_data.h"
+
+#define DRAWS               (1UL << 24)
+#define SPAN                (2 * ELT_PHASE3_RANDOM + 1)
+#define PAIR_GROUPS         16
+#define NEIGHBOURS          1000
+#define LOCKSTEP_DRAWS      64
+#define BENCH_DRAWS         (1UL << 26)
+
+static uint32_t value_counts[SPAN];
+static uint32_t pair_counts[PAIR_GROUPS][PAIR_GROUPS];
+
+// Chi-square limit: degrees of freedom plus six standard deviations
+static double chi2_limit(unsigned df) {
+    return df + 6.0 * sqrt(2.0 * df);
+}
+
+static unsigned pair_group(int16_t dither) {
+    return (unsigned)(dither + ELT_PHASE3_RANDOM) * PAIR_GROUPS / SPAN;
+}
+
+static void test_distribution(const beacon_config_2g_t* cfg) {
+    uint32_t state;
+    uint32_t group_width[PAIR_GROUPS];
+    int64_t sum = 0;
+    int16_t lo = ELT_PHASE3_RANDOM, hi = -ELT_PHASE3_RANDOM;
+    unsigned prev = 0;
+
+    memset(value_counts, 0, sizeof(value_counts));
+    memset(pair_counts, 0, sizeof(pair_counts));
+    memset(group_width, 0, sizeof(group_width));
+    for(int v = -ELT_PHASE3_RANDOM; v <= ELT_PHASE3_RANDOM; v++) {
+        group_width[pair_group((int16_t)v)]++;
+    }
+
+    elt_rng_seed_2g(&state, cfg);
+    for(uint32_t n = 0; n < DRAWS; n++) {
+        int16_t dither = elt_interval_dither_2g(&state);
+        unsigned group = pair_group(dither);
+
+        value_counts[dither + ELT_PHASE3_RANDOM]++;
+        if(n) {
+            pair_counts[prev][group]++;
+        }
+        prev = group;
+        sum += dither;
+        if(dither < lo) lo = dither;
+        if(dither > hi) hi = dither;
+    }
+
+    double expected = (double)DRAWS / SPAN;
+    double chi2_values = 0.0;
+    for(int k = 0; k < SPAN; k++) {
+        double delta = value_counts[k] - expected;
+        chi2_values += delta * delta / expected;
+    }
+
+    // Pair cell (i, j) has probability w_i * w_j / span^2
+    double chi2_pairs = 0.0;
+    for(int i = 0; i < PAIR_GROUPS; i++) {
+        for(int j = 0; j < PAIR_GROUPS; j++) {
+            double e = (double)(DRAWS - 1) * group_width[i] / SPAN * group_width[j] / SPAN;
+            double delta = pair_counts[i][j] - e;
+            chi2_pairs += delta * delta / e;
+        }
+    }
+
+    // Mean within 5 standard errors (uniform sd ~ span / sqrt(12))
+    double mean = (double)sum / DRAWS;
+    double mean_limit = 5.0 * (SPAN / sqrt(12.0)) / sqrt((double)DRAWS);
+
+    printf("Dither x%lu draws: chi2 values %.1f (limit %.1f), pairs %.1f (limit %.1f), mean %+.3f ms\n",
+           DRAWS, chi2_values, chi2_limit(SPAN - 1), chi2_pairs,
+           chi2_limit(PAIR_GROUPS * PAIR_GROUPS - 1), mean);
+    CHECK(chi2_values < chi2_limit(SPAN - 1));
+    CHECK(chi2_pairs < chi2_limit(PAIR_GROUPS * PAIR_GROUPS - 1));
+    CHECK_EQ(lo, -ELT_PHASE3_RANDOM);
+    CHECK_EQ(hi, ELT_PHASE3_RANDOM);
+    CHECK(fabs(mean) < mean_limit);
+}
+
+// Reseeding replays the sequence; nearby serials are not in lock-step
+static void test_replay_and_lockstep(const beacon_config_2g_t* cfg) {
+    uint32_t state, replay;
+    unsigned long matches = 0;
+    unsigned worst = 0;
+
+    elt_rng_seed_2g(&state, cfg);
+    replay = state;
+    for(uint32_t n = 0; n < 100000; n++) {
+        if(elt_interval_dither_2g(&state) != elt_interval_dither_2g(&replay)) {
+            CHECK(0);
+            break;
+        }
+    }
+
+    for(uint32_t k = 1; k <= NEIGHBOURS; k++) {
+        beacon_config_2g_t neighbour = *cfg;
+        uint32_t other;
+        unsigned same = 0;
+
+        neighbour.beacon_id ^= k;
+        elt_rng_seed_2g(&state, cfg);
+        elt_rng_seed_2g(&other, &neighbour);
+        for(int n = 0; n < LOCKSTEP_DRAWS; n++) {
+            same += (elt_interval_dither_2g(&state) == elt_interval_dither_2g(&other));
+        }
+        matches += same;
+        if(same > worst) worst = same;
+    }
+
+    // Expected LOCKSTEP_DRAWS / SPAN coincidences per neighbour
+    printf("Lock-step: %lu equal draws over %d neighbours x %d (%.1f expected), worst %u\n",
+           matches, NEIGHBOURS, LOCKSTEP_DRAWS, (double)NEIGHBOURS * LOCKSTEP_DRAWS / SPAN, worst);
+    CHECK(matches < 3.0 * NEIGHBOURS * LOCKSTEP_DRAWS / SPAN);
+    CHECK(worst <= 2);
+}
+
+// Phase 3 intervals stay within 28.5 s +/- 1.5 s
+static void test_interval_bounds(const beacon_config_2g_t* cfg) {
+    uint32_t state;
+    unsigned long out = 0;
+
+    elt_rng_seed_2g(&state, cfg);
+    for(uint32_t n = 0; n < 1000000; n++) {
+        int32_t interval = ELT_PHASE3_INTERVAL + elt_interval_dither_2g(&state);
+        out += interval < ELT_PHASE3_INTERVAL - ELT_PHASE3_RANDOM ||
+               interval > ELT_PHASE3_INTERVAL + ELT_PHASE3_RANDOM;
+    }
+    CHECK_EQ(out, 0);
+}
+
+static void bench_draws(const beacon_config_2g_t* cfg) {
+    uint32_t state;
+    int64_t sum = 0;
+
+    elt_rng_seed_2g(&state, cfg);
+    double start = host_seconds();
+    for(uint32_t n = 0; n < BENCH_DRAWS; n++) {
+        sum += elt_interval_dither_2g(&state);
+    }
+    double elapsed = host_seconds() - start;
+    printf("Dither: %.2f ns per draw (sum %lld)\n", elapsed * 1e9 / BENCH_DRAWS, (long long)sum);
+}
+
+int main(void) {
+    beacon_config_2g_t cfg = *get_beacon_config_2g();
+
+    CHECK_EQ(test_elt_interval_rng_2g(), 1);       // On-target known values
+    test_distribution(&cfg);
+    test_replay_and_lockstep(&cfg);
+    test_interval_bounds(&cfg);
+
+    // A second identity: the statistics do not depend on one lucky seed
+    cfg.beacon_id ^= 0x00ABCDEFUL;
+    cfg.vessel_id += 1;
+    test_distribution(&cfg);
+
+    bench_draws(&cfg);
+    return host_report("test_elt_rng");
+}
@@ -0,0 +1,157 @@
+/* test_frame_decoder.c
+ * Frame decoder: round trip of a known G008 field (Grenoble test position),
+ * the RLS and Cancel layouts, location cells back to their codes, and the
+ * bulk decode rate on the host
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "protocol_data.h"
+
+#define BULK_FRAMES         4000000L
+#define MIN_FRAMES_S        1000000.0   // Bulk validation: millions of frames/s
+
+static void pack_frame(uint8_t* info, const uint64_t* values, rotating_field_type_2g_t rf_type) {
+    const frame_layout_t* rotating = frame_rotating_layout(rf_type);
+    memset(info, 0, FRAME_INFO_BYTES);
+    frame_pack_fields(info, frame_main_layout.fields, frame_main_layout.count, values);
+    frame_pack_fields(info, rotating->fields, rotating->count, values);
+}
+
+static void grenoble_values(uint64_t* values) {
+    memset(values, 0, FIELD_NUM_SOURCES * sizeof(uint64_t));
+    values[FIELD_TAC] = 9999;
+    values[FIELD_SERIAL] = 0x1456;
+    values[FIELD_COUNTRY] = 228;
+    values[FIELD_PROTOCOL] = 2;
+    values[FIELD_LATITUDE] = latitude_to_code_2g(451885000L);
+    values[FIELD_LONGITUDE] = longitude_to_code_2g(57245000L);
+    values[FIELD_VESSEL_ID] = 0x123456789ABCULL;
+    values[FIELD_BEACON_TYPE] = 2;
+    values[FIELD_RF_TYPE] = RF_TYPE_G008_2G;
+    values[FIELD_RF_TIME] = 0xBEEF;
+    values[FIELD_RF_ALTITUDE] = altitude_to_code_2g(21400L);
+    values[FIELD_RF_SEQUENCE] = 0x2ABCD;
+}
+
+static void test_g008_round_trip(void) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint8_t info[FRAME_INFO_BYTES];
+    frame_decoded_2g_t frame;
+    char hex_id[24];
+
+    grenoble_values(values);
+    pack_frame(info, values, RF_TYPE_G008_2G);
+    CHECK_EQ(frame_decode_2g(info, &frame), 1);
+
+    CHECK_EQ(frame.tac, 9999);
+    CHECK_EQ(frame.serial, 0x1456);
+    CHECK_EQ(frame.country, 228);
+    CHECK_EQ(frame.protocol, 2);
+    CHECK_EQ(frame.beacon_type, 2);
+    CHECK_EQ(frame.vessel_id, 0x123456789ABCULL);
+    CHECK_EQ(frame.rotating.field_type, RF_TYPE_G008_2G);
+    CHECK_EQ(frame.rotating.time_value, 0xBEEF);
+    CHECK_EQ(frame.rotating.sequence, 0x2ABCD);
+
+    // Location back within half a code step (~107 and ~215 units of 1e-7 deg)
+    CHECK(frame.latitude_e7 - 451885000L >= -215 && frame.latitude_e7 - 451885000L <= 215);
+    CHECK(frame.longitude_e7 - 57245000L >= -215 && frame.longitude_e7 - 57245000L <= 215);
+    CHECK(frame.altitude_cm - 21400L >= -1809 && frame.altitude_cm - 21400L <= 1809);
+
+    generate_23hex_id_2g(info, hex_id);
+    CHECK(strcmp(frame.hex_id, hex_id) == 0);
+}
+
+static void test_other_types(void) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint8_t info[FRAME_INFO_BYTES];
+    frame_decoded_2g_t frame;
+
+    grenoble_values(values);
+    values[FIELD_RF_TYPE] = RF_TYPE_RLS_2G;
+    values[FIELD_RLS_PROVIDER] = 0xA5;
+    values[FIELD_RLS_DATA] = 0x876543210ULL;
+    pack_frame(info, values, RF_TYPE_RLS_2G);
+    CHECK_EQ(frame_decode_2g(info, &frame), 1);
+    CHECK_EQ(frame.rotating.rls_provider, 0xA5);
+    CHECK_EQ(frame.rotating.rls_data, 0x876543210ULL);
+
+    // Cancel: spare and fixed bits all 1s, anything else is malformed
+    values[FIELD_RF_TYPE] = RF_TYPE_CANCEL_2G;
+    values[FIELD_SPARE] = 0x3FFF;
+    values[FIELD_CANCEL_METHOD] = 2;
+    values[FIELD_CANCEL_FIXED] = 0x3FFFFFFFFFFULL;
+    pack_frame(info, values, RF_TYPE_CANCEL_2G);
+    CHECK_EQ(frame_decode_2g(info, &frame), 1);
+    CHECK_EQ(frame.rotating.deactivation_method, 2);
+    values[FIELD_CANCEL_FIXED] ^= 1ULL << 20;
+    pack_frame(info, values, RF_TYPE_CANCEL_2G);
+    CHECK_EQ(frame_decode_2g(info, &frame), 0);
+
+    // Unknown rotating type: fields still decoded, payload zeroed
+    values[FIELD_SPARE] = 0;
+    values[FIELD_RF_TYPE] = 0xF;
+    pack_frame(info, values, RF_TYPE_G008_2G);       // Type field packed as 0xF
+    CHECK_EQ(frame_decode_2g(info, &frame), 0);
+    CHECK_EQ(frame.tac, 9999);
+    CHECK_EQ(frame.rotating.time_value, 0);
+}
+
+// Decoded centres re-encode to the same codes across both ranges
+static void test_location_cells(void) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint8_t info[FRAME_INFO_BYTES];
+    frame_decoded_2g_t frame;
+    unsigned long bad = 0;
+
+    grenoble_values(values);
+    for(uint32_t i = 0; i < 65536; i++) {
+        uint32_t lat_code = (i * 127u) & 0x7FFFFF;
+        uint32_t lon_code = (i * 257u) & 0xFFFFFF;
+        uint16_t alt_code = (uint16_t)(i % 1024);
+        values[FIELD_LATITUDE] = lat_code;
+        values[FIELD_LONGITUDE] = lon_code;
+        values[FIELD_RF_ALTITUDE] = alt_code;
+        pack_frame(info, values, RF_TYPE_G008_2G);
+        frame_decode_2g(info, &frame);
+        bad += latitude_to_code_2g(frame.latitude_e7) != lat_code;
+        bad += longitude_to_code_2g(frame.longitude_e7) != lon_code;
+        bad += altitude_to_code_2g(frame.altitude_cm) != alt_code;
+    }
+    CHECK_EQ(bad, 0);
+}
+
+static void bench_bulk_decode(void) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    static uint8_t info[256][FRAME_INFO_BYTES];
+    frame_decoded_2g_t frame;
+    unsigned long well_formed = 0;
+
+    grenoble_values(values);
+    for(int i = 0; i < 256; i++) {
+        values[FIELD_SERIAL] = (uint64_t)i;
+        values[FIELD_RF_TIME] = (uint64_t)i * 251u;
+        pack_frame(info[i], values, RF_TYPE_G008_2G);
+    }
+
+    double start = host_seconds();
+    for(long n = 0; n < BULK_FRAMES; n++) {
+        well_formed += frame_decode_2g(info[n & 255], &frame);
+    }
+    double elapsed = host_seconds() - start;
+    double frames_s = BULK_FRAMES / elapsed;
+
+    CHECK_EQ(well_formed, (unsigned long)BULK_FRAMES);
+    printf("Bulk decode x%ld: %.0f ns/frame, %.2f M frames/s\n",
+           BULK_FRAMES, elapsed * 1e9 / BULK_FRAMES, frames_s / 1e6);
+    CHECK(frames_s > MIN_FRAMES_S);
+}
+
+int main(void) {
+    test_g008_round_trip();
+    test_other_types();
+    test_location_cells();
+    bench_bulk_decode();
+    return host_report("test_frame_decoder");
+}
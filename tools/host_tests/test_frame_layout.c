@@ -0,0 +1,128 @@
+/* test_frame_layout.c
+ * Field descriptor tables gap-free over the information field, the packer
+ * and unpacker against per-field set_bit_field_64 writes for every rotating
+ * type, and the cost of each path per G008 information field
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "protocol_data.h"
+
+#define BENCH_FRAMES        1000000L
+
+static uint8_t frame_layout_contiguous(const frame_layout_t* layout, uint8_t start, uint8_t end) {
+    uint8_t bit = start;
+    for(uint8_t i = 0; i < layout->count; i++) {
+        if(layout->fields[i].start != bit) return 0;
+        bit += layout->fields[i].width;
+    }
+    return bit == end;
+}
+
+// Hand-written path: one bit loop per field
+static void frame_pack_reference(uint8_t* info_bits, const frame_layout_t* layout, const uint64_t* values) {
+    for(uint8_t i = 0; i < layout->count; i++) {
+        const frame_field_desc_t* f = &layout->fields[i];
+        set_bit_field_64(info_bits, f->start, f->width, values[f->source]);
+    }
+}
+
+static uint8_t frame_fields_match(const frame_layout_t* layout, const uint64_t* a, const uint64_t* b) {
+    for(uint8_t i = 0; i < layout->count; i++) {
+        const frame_field_desc_t* f = &layout->fields[i];
+        uint64_t mask = (1ULL << f->width) - 1;
+        if((a[f->source] & mask) != (b[f->source] & mask)) return 0;
+    }
+    return 1;
+}
+
+// Distinct pattern per source: a swapped or shifted field shows up
+static void make_values(uint64_t* values, uint64_t salt) {
+    for(uint8_t i = 0; i < FIELD_NUM_SOURCES; i++) {
+        values[i] = 0x9E3779B97F4A7C15ULL * (i + 1) ^ salt;
+    }
+}
+
+static void test_tables_and_round_trip(void) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint64_t readback[FIELD_NUM_SOURCES];
+    uint8_t packed[FRAME_INFO_BYTES];
+    uint8_t reference[FRAME_INFO_BYTES];
+
+    CHECK(frame_layout_contiguous(&frame_main_layout, 0, FRAME_ROTATING_START_BIT));
+
+    for(uint64_t salt = 0; salt < 64; salt++) {
+        make_values(values, salt * 0xD1B54A32D192ED03ULL);
+
+        for(uint8_t type = RF_TYPE_G008_2G; type <= RF_TYPE_CANCEL_2G; type++) {
+            const frame_layout_t* rotating = frame_rotating_layout((rotating_field_type_2g_t)type);
+            CHECK(frame_layout_contiguous(rotating, FRAME_ROTATING_START_BIT, INFO_BITS));
+
+            memset(packed, 0, sizeof(packed));
+            memset(reference, 0, sizeof(reference));
+            frame_pack_fields(packed, frame_main_layout.fields, frame_main_layout.count, values);
+            frame_pack_fields(packed, rotating->fields, rotating->count, values);
+            frame_pack_reference(reference, &frame_main_layout, values);
+            frame_pack_reference(reference, rotating, values);
+            CHECK(memcmp(packed, reference, sizeof(packed)) == 0);
+
+            memset(readback, 0, sizeof(readback));
+            frame_unpack_fields(packed, frame_main_layout.fields, frame_main_layout.count, readback);
+            frame_unpack_fields(packed, rotating->fields, rotating->count, readback);
+            CHECK(frame_fields_match(&frame_main_layout, values, readback));
+            CHECK(frame_fields_match(rotating, values, readback));
+        }
+    }
+}
+
+// Whole G008 information field each way
+static void bench_g008(void) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint64_t readback[FIELD_NUM_SOURCES];
+    uint8_t packed[FRAME_INFO_BYTES];
+    uint8_t reference[FRAME_INFO_BYTES];
+    const frame_layout_t* rotating = frame_rotating_layout(RF_TYPE_G008_2G);
+    uint64_t sink = 0;
+
+    make_values(values, 0);
+    memset(packed, 0, sizeof(packed));
+    memset(reference, 0, sizeof(reference));
+
+    double start = host_seconds();
+    for(long run = 0; run < BENCH_FRAMES; run++) {
+        values[FIELD_SERIAL] = (uint64_t)run;
+        frame_pack_fields(packed, frame_main_layout.fields, frame_main_layout.count, values);
+        frame_pack_fields(packed, rotating->fields, rotating->count, values);
+        sink += packed[run % FRAME_INFO_BYTES];
+    }
+    double pack_s = host_seconds() - start;
+
+    start = host_seconds();
+    for(long run = 0; run < BENCH_FRAMES; run++) {
+        values[FIELD_SERIAL] = (uint64_t)run;
+        frame_pack_reference(reference, &frame_main_layout, values);
+        frame_pack_reference(reference, rotating, values);
+        sink += reference[run % FRAME_INFO_BYTES];
+    }
+    double reference_s = host_seconds() - start;
+
+    start = host_seconds();
+    for(long run = 0; run < BENCH_FRAMES; run++) {
+        packed[run % FRAME_INFO_BYTES] ^= 1;
+        frame_unpack_fields(packed, frame_main_layout.fields, frame_main_layout.count, readback);
+        frame_unpack_fields(packed, rotating->fields, rotating->count, readback);
+        sink += readback[FIELD_SERIAL];
+    }
+    double unpack_s = host_seconds() - start;
+
+    printf("G008 field x%ld: packer %.1f ns, per-field writes %.1f ns, unpacker %.1f ns (%llu)\n",
+           BENCH_FRAMES, pack_s * 1e9 / BENCH_FRAMES, reference_s * 1e9 / BENCH_FRAMES,
+           unpack_s * 1e9 / BENCH_FRAMES, (unsigned long long)(sink & 0xF));
+    CHECK(pack_s < reference_s);
+}
+
+int main(void) {
+    test_tables_and_round_trip();
+    bench_g008();
+    return host_report("test_frame_layout");
+}
@@ -0,0 +1,110 @@
+/* test_gps_nmea.c
+ * NMEA GGA/RMC parser: reference sentences, checksum rejection, and the
+ * byte-at-a-time throughput of nmea_process_byte() on a 1 Hz receiver stream
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_support.h"
+#include "system_comms.h"
+
+#define CAPTURE_PATH        "data/nmea_1hz_60s.nmea"
+#define CAPTURE_MAX_BYTES   65536
+#define CAPTURE_EPOCHS      60          // 1 Hz for 60 s
+#define BENCH_PASSES        2000
+
+// GPS UART2 payload rates (8N1: 10 bits per byte)
+#define LINK_4800_BYTES_S   480.0
+#define LINK_9600_BYTES_S   960.0
+
+// The dsPIC runs well over 20x slower than a desktop core; demanding 1000x
+// the 9600-baud byte rate here keeps a wide margin on the target too
+#define MIN_HOST_MARGIN     1000.0
+
+static char capture[CAPTURE_MAX_BYTES];
+
+static uint8_t feed(const char* text, size_t len) {
+    uint8_t fixes = 0;
+    for(size_t i = 0; i < len; i++) {
+        fixes += nmea_process_byte(text[i]);
+    }
+    return fixes;
+}
+
+static uint8_t parse_copy(const char* sentence) {
+    char buffer[NMEA_BUFFER_SIZE];
+    strncpy(buffer, sentence, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    return parse_nmea_sentence(buffer);
+}
+
+static void test_reference_sentences(gps_data_t* gps) {
+    CHECK_EQ(parse_copy("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47"), 1);
+    CHECK_EQ(gps->latitude_e7, 481173000);
+    CHECK_EQ(gps->longitude_e7, 115166667);
+    CHECK_EQ(gps->altitude_cm, 54540);
+    CHECK_EQ(gps->satellites, 8);
+    CHECK_EQ(gps->hour * 10000 + gps->minute * 100 + gps->second, 123519);
+
+    CHECK_EQ(parse_copy("$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A"), 1);
+    CHECK_EQ(gps->year * 10000 + gps->month * 100 + gps->day, 20940323);   // yy -> 20yy
+
+    // Southern / western hemispheres and any talker ID
+    CHECK_EQ(parse_copy("$GNGGA,000001,3356.5000,S,15112.2500,W,2,12,0.7,-12.3,M,,M,,*51"), 1);
+    CHECK_EQ(gps->latitude_e7, -339416667);
+    CHECK_EQ(gps->longitude_e7, -1512041667);
+    CHECK_EQ(gps->altitude_cm, -1230);
+
+    // Corrupted checksum, missing checksum, receiver warning, no fix
+    CHECK_EQ(parse_copy("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48"), 0);
+    CHECK_EQ(parse_copy("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,"), 0);
+    CHECK_EQ(parse_copy("$GPRMC,123519,V,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*7D"), 0);
+    CHECK_EQ(parse_copy("$GPGGA,123519,,,,,0,00,,,M,,M,,*6B"), 0);
+    CHECK_EQ(gps->valid, 0);
+}
+
+static size_t load_capture(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if(f == NULL) {
+        printf("cannot open %s\n", path);
+        exit(1);
+    }
+    size_t len = fread(capture, 1, sizeof(capture), f);
+    fclose(f);
+    return len;
+}
+
+int main(int argc, char** argv) {
+    // Exercise mode: get_current_gps_data() returns the live fix
+    PORTCbits.RC0 = 1;
+    gps_init();
+    gps_data_t* gps = get_current_gps_data();
+
+    test_reference_sentences(gps);
+
+    // Whole capture: one GGA and one RMC fix per second, other talkers ignored
+    size_t len = load_capture(argc > 1 ? argv[1] : CAPTURE_PATH);
+    unsigned fixes = feed(capture, len);
+    CHECK_EQ(fixes, 2 * CAPTURE_EPOCHS);
+    CHECK(gps->valid);
+    CHECK_EQ(gps->hour * 10000 + gps->minute * 100 + gps->second, 123144);
+    CHECK(gps->latitude_e7 > 451880000 && gps->latitude_e7 < 451890000);
+    CHECK(gps->longitude_e7 > 57240000 && gps->longitude_e7 < 57250000);
+
+    // Throughput of the byte path the main loop uses
+    unsigned long total_fixes = 0;
+    double start = host_seconds();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        total_fixes += feed(capture, len);
+    }
+    double elapsed = host_seconds() - start;
+    double bytes_s = (double)len * BENCH_PASSES / elapsed;
+
+    CHECK_EQ(total_fixes, 2UL * CAPTURE_EPOCHS * BENCH_PASSES);
+    printf("NMEA: %zu bytes/epoch, %.0f ns/epoch, %.1f ns/byte = %.0fx 9600 baud, %.0fx 4800 baud\n",
+           len / CAPTURE_EPOCHS, elapsed * 1e9 / ((double)CAPTURE_EPOCHS * BENCH_PASSES),
+           1e9 / bytes_s, bytes_s / LINK_9600_BYTES_S, bytes_s / LINK_4800_BYTES_S);
+    CHECK(bytes_s > MIN_HOST_MARGIN * LINK_9600_BYTES_S);
+
+    return host_report("test_gps_nmea");
+}
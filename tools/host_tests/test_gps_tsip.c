@@ -0,0 +1,195 @@
+/* test_gps_tsip.c
+ * TSIP decoder (GPS_PROTOCOL_TSIP build): 0x8F-20 fix, 0x8F-AB timing flags
+ * and GPS->UTC conversion, DLE stuffing, and the cost per 1 Hz epoch to set
+ * against test_gps_nmea
+ */
+
+#include <math.h>
+#include <string.h>
+#include "host_support.h"
+#include "system_comms.h"
+
+#define EPOCHS              60
+#define BENCH_PASSES        2000
+#define STREAM_MAX_BYTES    (EPOCHS * 2 * 2 * (56 + 4))
+
+#define LINK_9600_BYTES_S   960.0
+#define MIN_HOST_MARGIN     1000.0      // Same margin as test_gps_nmea
+
+#define FIX_LEN             56
+#define TIMING_LEN          17
+
+static uint8_t stream[STREAM_MAX_BYTES];
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)(v >> 16));
+    put_u16(p + 2, (uint16_t)v);
+}
+
+// Frame one report: DLE 0x8F <data, DLE doubled> DLE ETX
+static size_t frame_packet(uint8_t* out, const uint8_t* data, uint8_t len) {
+    size_t n = 0;
+    out[n++] = TSIP_DLE;
+    out[n++] = TSIP_ID_SUPER;
+    for(uint8_t i = 0; i < len; i++) {
+        out[n++] = data[i];
+        if(data[i] == TSIP_DLE) {
+            out[n++] = TSIP_DLE;
+        }
+    }
+    out[n++] = TSIP_DLE;
+    out[n++] = TSIP_ETX;
+    return n;
+}
+
+static void make_fix(uint8_t* d, double lat_deg, double lon_deg, int32_t alt_mm, uint8_t flags) {
+    memset(d, 0, FIX_LEN);
+    d[0] = TSIP_SUB_FIX_EXTRA;
+    put_u32(&d[12], (uint32_t)(int32_t)llround(lat_deg / 180.0 * 2147483648.0));
+    put_u32(&d[16], (uint32_t)(int32_t)llround(lon_deg / 180.0 * 2147483648.0));
+    put_u32(&d[20], (uint32_t)alt_mm);
+    d[27] = flags;
+    d[28] = 9;
+}
+
+static void make_timing(uint8_t* d, int16_t utc_offset, uint8_t flags,
+                        uint8_t h, uint8_t m, uint8_t s, uint8_t day, uint8_t month, uint16_t year) {
+    memset(d, 0, TIMING_LEN);
+    d[0] = TSIP_SUB_TIMING;
+    put_u16(&d[7], (uint16_t)utc_offset);
+    d[9] = flags;
+    d[10] = s;
+    d[11] = m;
+    d[12] = h;
+    d[13] = day;
+    d[14] = month;
+    put_u16(&d[15], year);
+}
+
+static uint8_t feed(const uint8_t* bytes, size_t len) {
+    uint8_t fixes = 0;
+    for(size_t i = 0; i < len; i++) {
+        fixes += tsip_process_byte(bytes[i]);
+    }
+    return fixes;
+}
+
+static uint8_t send(const uint8_t* data, uint8_t len) {
+    uint8_t packet[2 * FIX_LEN + 4];
+    return feed(packet, frame_packet(packet, data, len));
+}
+
+#define CHECK_TIME(gps, y, mo, d, h, mi, s) do { \
+    CHECK_EQ((gps)->year * 10000L + (gps)->month * 100 + (gps)->day, (y) * 10000L + (mo) * 100 + (d)); \
+    CHECK_EQ((gps)->hour * 10000L + (gps)->minute * 100 + (gps)->second, (h) * 10000L + (mi) * 100 + (s)); \
+} while(0)
+
+static void test_fix(gps_data_t* gps) {
+    uint8_t d[FIX_LEN];
+
+    make_fix(d, 45.1885, 5.7245, 263000, 0x00);
+    CHECK_EQ(send(d, FIX_LEN), 1);
+    CHECK(gps->valid);
+    CHECK_EQ(gps->latitude_e7, 451885000);
+    CHECK_EQ(gps->longitude_e7, 57245000);
+    CHECK_EQ(gps->altitude_cm, 26300 - TSIP_GEOID_SEPARATION_CM);
+    CHECK_EQ(gps->satellites, 9);
+    CHECK_EQ(gps->fix_quality, 1);
+
+    // Southern/western fix with a DLE (0x10) byte to unstuff inside the data
+    make_fix(d, -33.9416667, -151.2041667, -12000, 0x02);
+    d[2] = TSIP_DLE;       // East velocity MSB
+    CHECK_EQ(send(d, FIX_LEN), 1);
+    CHECK_EQ(gps->fix_quality, 2);
+    CHECK(gps->latitude_e7 < -339000000 && gps->latitude_e7 > -340000000);
+    CHECK(gps->longitude_e7 > -1512100000 && gps->longitude_e7 < -1512000000);
+
+    // No fix available
+    make_fix(d, 45.0, 5.0, 0, 0x01);
+    CHECK_EQ(send(d, FIX_LEN), 0);
+    CHECK_EQ(gps->valid, 0);
+}
+
+static void test_timing(gps_data_t* gps) {
+    uint8_t d[TIMING_LEN];
+
+    // UTC date/time is taken as is
+    make_timing(d, 18, TSIP_TIMING_UTC, 12, 30, 45, 15, 11, 2024);
+    CHECK_EQ(send(d, TIMING_LEN), 0);
+    CHECK_TIME(gps, 2024, 11, 15, 12, 30, 45);
+
+    // GPS time: minus the 18 s offset, across a year boundary
+    make_timing(d, 18, 0, 0, 0, 10, 1, 1, 2025);
+    send(d, TIMING_LEN);
+    CHECK_TIME(gps, 2024, 12, 31, 23, 59, 52);
+
+    // Across a leap day going backwards and forwards
+    make_timing(d, 18, 0, 0, 0, 5, 1, 3, 2024);
+    send(d, TIMING_LEN);
+    CHECK_TIME(gps, 2024, 2, 29, 23, 59, 47);
+    make_timing(d, -3, 0, 23, 59, 58, 28, 2, 2023);
+    send(d, TIMING_LEN);
+    CHECK_TIME(gps, 2023, 3, 1, 0, 0, 1);
+
+    // Mid-day GPS time, no date change
+    make_timing(d, 18, 0, 8, 15, 30, 10, 6, 2025);
+    send(d, TIMING_LEN);
+    CHECK_TIME(gps, 2025, 6, 10, 8, 15, 12);
+
+    // Rejected: time not set, or GPS time without the UTC offset
+    make_timing(d, 18, TSIP_TIMING_UTC | TSIP_TIMING_NOT_SET, 1, 2, 3, 4, 5, 2026);
+    send(d, TIMING_LEN);
+    CHECK_TIME(gps, 2025, 6, 10, 8, 15, 12);
+    make_timing(d, 0, TSIP_TIMING_NO_UTC, 1, 2, 3, 4, 5, 2026);
+    send(d, TIMING_LEN);
+    CHECK_TIME(gps, 2025, 6, 10, 8, 15, 12);
+}
+
+// One epoch per second: 0x8F-20 fix then 0x8F-AB timing, like the NMEA capture
+static size_t build_stream(void) {
+    uint8_t fix[FIX_LEN];
+    uint8_t timing[TIMING_LEN];
+    size_t n = 0;
+
+    for(int k = 0; k < EPOCHS; k++) {
+        make_fix(fix, 45.1885 + k * 1e-6, 5.7245 - k * 1e-6, 263000 + k * 10, 0x00);
+        make_timing(timing, 18, 0, 12, 30 + (63 + k) / 60, (63 + k) % 60, 15, 11, 2024);
+        n += frame_packet(&stream[n], fix, FIX_LEN);
+        n += frame_packet(&stream[n], timing, TIMING_LEN);
+    }
+    return n;
+}
+
+int main(void) {
+    PORTCbits.RC0 = 1;      // Exercise mode: live fix
+    gps_init();
+    gps_data_t* gps = get_current_gps_data();
+
+    test_fix(gps);
+    test_timing(gps);
+
+    size_t len = build_stream();
+    CHECK_EQ(feed(stream, len), EPOCHS);
+    CHECK_TIME(gps, 2024, 11, 15, 12, 31, 44);
+
+    unsigned long total_fixes = 0;
+    double start = host_seconds();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        total_fixes += feed(stream, len);
+    }
+    double elapsed = host_seconds() - start;
+    double bytes_s = (double)len * BENCH_PASSES / elapsed;
+
+    CHECK_EQ(total_fixes, (unsigned long)EPOCHS * BENCH_PASSES);
+    printf("TSIP: %zu bytes/epoch, %.0f ns/epoch, %.1f ns/byte = %.0fx 9600 baud\n",
+           len / EPOCHS, elapsed * 1e9 / ((double)EPOCHS * BENCH_PASSES),
+           1e9 / bytes_s, bytes_s / LINK_9600_BYTES_S);
+    CHECK(bytes_s > MIN_HOST_MARGIN * LINK_9600_BYTES_S);
+
+    return host_report("test_gps_tsip");
+}
@@ -0,0 +1,107 @@
+/* test_position_encoders.c
+ * Fixed-point location/altitude encoders against the float reference they
+ * replaced, over every 1e-7 degree latitude and longitude and every
+ * altitude centimetre of the field ranges
+ */
+
+#include "host_support.h"
+#include "protocol_data.h"
+
+// Float encoders as they were before the fixed-point rewrite (degrees and
+// metres in). They wrap instead of saturating at +90 / +180, so the range
+// ends are checked separately
+static uint32_t reference_latitude_code(double latitude) {
+    return (uint32_t)(int32_t)((latitude + 90.0) * (1L << 23) / 180.0) & 0x7FFFFF;
+}
+
+static uint32_t reference_longitude_code(double longitude) {
+    return (uint32_t)(int32_t)((longitude + 180.0) * (1L << 24) / 360.0) & 0xFFFFFF;
+}
+
+static uint16_t reference_altitude_code(double altitude) {
+    if(altitude < -1500) return 0;
+    if(altitude > 17000) return 1023;
+    return (uint16_t)((int16_t)((altitude + 1500) * 1023.0 / 18500.0) & 0x3FF);
+}
+
+// Single precision, as the target ran the reference (32-bit double)
+static uint32_t reference_latitude_code_f32(float latitude) {
+    return (uint32_t)(int32_t)((latitude + 90.0f) * (float)(1L << 23) / 180.0f) & 0x7FFFFF;
+}
+
+// Exact floor(u * 2^14 / 3515625): the definition of both position codes
+static uint32_t exact_position_code(uint64_t u) {
+    return (uint32_t)((u << 14) / 3515625ULL);
+}
+
+static void sweep_latitude(void) {
+    unsigned long exact_bad = 0, reference_bad = 0;
+    for(int64_t e7 = -900000000LL; e7 < 900000000LL; e7++) {
+        uint32_t code = latitude_to_code_2g((int32_t)e7);
+        exact_bad += code != exact_position_code((uint64_t)(e7 + 900000000LL));
+        reference_bad += code != reference_latitude_code((double)e7 / 1e7);
+    }
+    printf("latitude: 1800000000 inputs, %lu exact mismatches, %lu float reference mismatches\n",
+           exact_bad, reference_bad);
+    CHECK_EQ(exact_bad, 0);
+    CHECK_EQ(reference_bad, 0);
+}
+
+static void sweep_longitude(void) {
+    unsigned long exact_bad = 0, reference_bad = 0;
+    for(int64_t e7 = -1800000000LL; e7 < 1800000000LL; e7++) {
+        uint32_t code = longitude_to_code_2g((int32_t)e7);
+        exact_bad += code != exact_position_code((uint64_t)(e7 + 1800000000LL));
+        reference_bad += code != reference_longitude_code((double)e7 / 1e7);
+    }
+    printf("longitude: 3600000000 inputs, %lu exact mismatches, %lu float reference mismatches\n",
+           exact_bad, reference_bad);
+    CHECK_EQ(exact_bad, 0);
+    CHECK_EQ(reference_bad, 0);
+}
+
+static void sweep_altitude(void) {
+    unsigned long exact_bad = 0, reference_bad = 0;
+    for(int32_t cm = -200000; cm <= 1800000; cm++) {
+        uint16_t code = altitude_to_code_2g(cm);
+        int64_t v = (int64_t)cm + 150000;
+        if(v < 0) v = 0;
+        if(v > 1850000) v = 1850000;
+        exact_bad += code != (uint16_t)(v * 1023 / 1850000);
+        reference_bad += code != reference_altitude_code(cm / 100.0);
+    }
+    printf("altitude: 2000001 inputs, %lu exact mismatches, %lu float reference mismatches\n",
+           exact_bad, reference_bad);
+    CHECK_EQ(exact_bad, 0);
+    CHECK_EQ(reference_bad, 0);
+}
+
+int main(void) {
+    // Range ends: saturate where the float reference wrapped
+    CHECK_EQ(latitude_to_code_2g(-900000001L), 0);
+    CHECK_EQ(latitude_to_code_2g(900000000L), 0x7FFFFF);
+    CHECK_EQ(reference_latitude_code(90.0), 0);
+    CHECK_EQ(longitude_to_code_2g(-1800000000L - 1), 0);
+    CHECK_EQ(longitude_to_code_2g(1800000000L), 0xFFFFFF);
+    CHECK_EQ(altitude_to_code_2g(-150000L), 0);
+    CHECK_EQ(altitude_to_code_2g(1700000L), 1023);
+
+    // Grenoble test position
+    CHECK_EQ(latitude_to_code_2g(451885000L), 6300240);
+    CHECK_EQ(longitude_to_code_2g(57245000L), 8655389);
+    CHECK_EQ(altitude_to_code_2g(21400L), 94);
+
+    sweep_latitude();
+    sweep_longitude();
+    sweep_altitude();
+
+    // What the rewrite fixed: the single-precision path missed by one LSB
+    unsigned long f32_bad = 0, samples = 0;
+    for(int64_t e7 = -900000000LL; e7 < 900000000LL; e7 += 997) {
+        f32_bad += latitude_to_code_2g((int32_t)e7) != reference_latitude_code_f32((float)e7 * 1e-7f);
+        samples++;
+    }
+    printf("latitude float32 reference: %lu / %lu sampled inputs differ\n", f32_bad, samples);
+
+    return host_report("test_position_encoders");
+}
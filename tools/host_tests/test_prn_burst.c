@@ -0,0 +1,61 @@
+/* test_prn_burst.c
+ * Whole bursts through transmit_beacon_2g() with the CCP1 ISR run from
+ * Idle(): one wake-up per chip and no underrun, the PRN restarted for each
+ * burst (same chips on air twice), and the PRN self-test still passing
+ * when it runs deferred, after a burst
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "spi_sim.h"
+#include "system_definitions.h"
+#include "rf_interface.h"
+#include "system_comms.h"
+
+#define BURST_CHIPS         ((unsigned long)FRAME_TOTAL_BITS * PRN_CHIPS_PER_BIT)
+
+void _CCP1Interrupt(void);
+void _CNBInterrupt(void);
+
+static spi_sim_word_t first_burst[SPI_SIM_LOG_SIZE];
+
+// Burst trigger, then the lock detect edge
+static void rf_ready(void) {
+    rf_bringup_start();
+    ADF_MUXOUT_PORT = 1;
+    CNFBbits.CNFB0 = 1;
+    _CNBInterrupt();
+    CHECK_EQ(rf_bringup_get_state(), RF_BRINGUP_READY);
+}
+
+static void run_burst(void) {
+    rf_ready();
+    spi_sim_reset();
+    spi_sim_set_idle_hook(_CCP1Interrupt);
+    transmit_beacon_2g();
+    spi_sim_set_idle_hook(NULL);
+
+    CHECK_EQ(oqpsk_is_transmitting(), 0);
+    CHECK_EQ(spi_sim_stats.idles, BURST_CHIPS);
+    CHECK(spi_sim_stats.words >= 2 * BURST_CHIPS);
+    CHECK_EQ(spi_get_sched_stats()->chip_underruns, 0);
+    CHECK_EQ(spi_sim_stats.cs_conflicts, 0);
+}
+
+int main(void) {
+    CHECK_EQ(verify_prn_sequence(PRN_MODE_NORMAL), 1);     // Boot POST
+
+    run_burst();
+    memcpy(first_burst, spi_sim_log, sizeof(first_burst));
+
+    // Cached POST: the self-test runs after the first burst
+    CHECK_EQ(verify_prn_sequence(PRN_MODE_NORMAL), 1);
+
+    // The self-test leaves the transmit generator alone and the next burst
+    // starts from the same chips
+    run_burst();
+    CHECK(memcmp(first_burst, spi_sim_log, sizeof(first_burst)) == 0);
+    CHECK_EQ(verify_prn_sequence(PRN_MODE_NORMAL), 1);
+
+    return host_report("test_prn_burst");
+}
@@ -0,0 +1,24 @@
+/* test_ram_plan.c
+ * Frame arena RAM plan: prints the per-phase peak table the firmware build
+ * asserts (FRAME_ARENA_PHASES), with the same region structs
+ */
+
+#include "host_support.h"
+#include "protocol_data.h"
+
+#define PRINT_PHASE(name, bytes, budget) \
+    printf("  %-10s %5u / %5u bytes\n", #name, (unsigned)(bytes), (unsigned)(budget)); \
+    CHECK((bytes) <= (budget));
+
+int main(void) {
+    printf("Frame arena: %u / %u bytes (build %u, transmit %u, self-test %u)\n",
+           (unsigned)sizeof(frame_arena_t), (unsigned)FRAME_ARENA_BUDGET_BYTES,
+           (unsigned)FRAME_ARENA_BUILD_BYTES, (unsigned)FRAME_ARENA_TX_BYTES,
+           (unsigned)FRAME_ARENA_SELFTEST_BYTES);
+    CHECK(sizeof(frame_arena_t) <= FRAME_ARENA_BUDGET_BYTES);
+
+    printf("Peak per phase:\n");
+    FRAME_ARENA_PHASES(PRINT_PHASE)
+
+    return host_report("test_ram_plan");
+}
@@ -0,0 +1,124 @@
+/* test_rf_scheduler.c
+ * Rotating field scheduler: cycle order and codewords (table lookup plus
+ * parity XOR) bit for bit against a full rebuild, re-encode counts, and the
+ * burst-time cost of each path
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "protocol_data.h"
+#include "error_correction.h"
+
+#define BENCH_FRAMES        200000L
+
+static const rotating_field_type_2g_t all_types[RF_SCHED_NUM_TYPES] = {
+    RF_TYPE_G008_2G, RF_TYPE_ELTDT_2G, RF_TYPE_RLS_2G, RF_TYPE_CANCEL_2G
+};
+
+// Full per-burst path: gather every field, pack through the layout tables,
+// unpack to one bit per byte and run the BCH over all 202 bits
+static void reference_codeword(uint8_t* codeword, rotating_field_type_2g_t rf_type) {
+    uint64_t values[FIELD_NUM_SOURCES];
+    uint8_t bits[INFO_BITS];
+    const frame_layout_t* rotating = frame_rotating_layout(rf_type);
+
+    beacon_config_2g.rotating_type = rf_type;
+    frame_gather_fields_2g(values);
+    memset(codeword, 0, FRAME_CODEWORD_BYTES);
+    frame_pack_fields(codeword, frame_main_layout.fields, frame_main_layout.count, values);
+    frame_pack_fields(codeword, rotating->fields, rotating->count, values);
+
+    for(uint8_t i = 0; i < INFO_BITS; i++) {
+        bits[i] = get_bit_field(codeword, i, 1);
+    }
+    set_bit_field_64(codeword, INFO_BITS, BCH_PARITY_BITS, compute_bch_250_202(bits));
+}
+
+static unsigned long codeword_mismatches(rotating_field_type_2g_t rf_type) {
+    uint8_t codeword[FRAME_CODEWORD_BYTES];
+    uint8_t reference[FRAME_CODEWORD_BYTES];
+
+    rf_sched_build_codeword_2g(codeword, rf_type);
+    reference_codeword(reference, rf_type);
+    return memcmp(codeword, reference, FRAME_CODEWORD_BYTES) != 0;
+}
+
+// Two passes over a cycle of all four types: same order, same codewords,
+// and one encode per block plus one for the main fields
+static void test_cycle(void) {
+    unsigned long bad_order = 0, bad_codeword = 0;
+
+    rf_sched_configure_2g(all_types, RF_SCHED_NUM_TYPES);
+    uint16_t encodes_start = rf_sched_2g.encodes;
+    rf_sched_refresh_2g();
+
+    for(uint8_t n = 0; n < 2 * RF_SCHED_NUM_TYPES; n++) {
+        rotating_field_type_2g_t rf_type = rf_sched_next_2g();
+        bad_order += rf_type != all_types[n % RF_SCHED_NUM_TYPES];
+        bad_codeword += codeword_mismatches(rf_type);
+    }
+    CHECK_EQ(bad_order, 0);
+    CHECK_EQ(bad_codeword, 0);
+    CHECK_EQ(rf_sched_2g.encodes - encodes_start, RF_SCHED_NUM_TYPES + 1);
+
+    // New main fields: main parity again, rotating blocks reused
+    encodes_start = rf_sched_2g.encodes;
+    beacon_config_2g.vessel_id ^= 0x5A5A5AULL;
+    for(uint8_t n = 0; n < RF_SCHED_NUM_TYPES; n++) {
+        bad_codeword += codeword_mismatches(rf_sched_next_2g());
+    }
+    CHECK_EQ(bad_codeword, 0);
+    CHECK_EQ(rf_sched_2g.encodes - encodes_start, 1);
+    beacon_config_2g.vessel_id ^= 0x5A5A5AULL;
+}
+
+// Invalid types dropped; an empty cycle falls back to G008
+static void test_configure(void) {
+    static const rotating_field_type_2g_t mixed[3] = {
+        RF_TYPE_RLS_2G, (rotating_field_type_2g_t)9, RF_TYPE_CANCEL_2G
+    };
+
+    rf_sched_configure_2g(mixed, 3);
+    CHECK_EQ(rf_sched_2g.length, 2);
+    CHECK_EQ(rf_sched_next_2g(), RF_TYPE_RLS_2G);
+    CHECK_EQ(rf_sched_next_2g(), RF_TYPE_CANCEL_2G);
+    CHECK_EQ(rf_sched_next_2g(), RF_TYPE_RLS_2G);
+
+    rf_sched_configure_2g(mixed, 0);
+    CHECK_EQ(rf_sched_2g.length, 1);
+    CHECK_EQ(rf_sched_next_2g(), RF_TYPE_G008_2G);
+}
+
+// Burst-time cost of each path for a G008 frame
+static void bench_g008(void) {
+    uint8_t codeword[FRAME_CODEWORD_BYTES];
+    unsigned long sink = 0;
+
+    rf_sched_configure_2g(all_types, RF_SCHED_NUM_TYPES);
+    rf_sched_refresh_2g();
+
+    double start = host_seconds();
+    for(long run = 0; run < BENCH_FRAMES; run++) {
+        rf_sched_build_codeword_2g(codeword, RF_TYPE_G008_2G);
+        sink += codeword[run % FRAME_CODEWORD_BYTES];
+    }
+    double table_s = host_seconds() - start;
+
+    start = host_seconds();
+    for(long run = 0; run < BENCH_FRAMES; run++) {
+        reference_codeword(codeword, RF_TYPE_G008_2G);
+        sink += codeword[run % FRAME_CODEWORD_BYTES];
+    }
+    double full_s = host_seconds() - start;
+
+    printf("G008 codeword x%ld: table %.0f ns, full rebuild %.0f ns (%lu)\n",
+           BENCH_FRAMES, table_s * 1e9 / BENCH_FRAMES, full_s * 1e9 / BENCH_FRAMES, sink & 0xF);
+    CHECK(table_s < full_s);
+}
+
+int main(void) {
+    test_cycle();
+    test_configure();
+    bench_g008();
+    return host_report("test_rf_scheduler");
+}
@@ -0,0 +1,168 @@
+/* test_spi_sched.c
+ * SPI transaction scheduler: the chip pair goes out before any configuration
+ * word and at most one configuration word per tick, no underruns counted
+ * while draining, the stall path when the background queue is full, and
+ * spi_stream_stop() flushing what is still queued, in order
+ */
+
+#include <string.h>
+#include "host_support.h"
+#include "spi_sim.h"
+#include "system_definitions.h"
+#include "rf_interface.h"
+
+#define CHIP_I(n)           (0x3000 | (n))      // MCP4922 DAC A words
+#define CHIP_Q(n)           (0xB000 | (n))      // MCP4922 DAC B words
+#define CONFIG_WORD(n)      (0x00A50000UL | ((n) << 4) | 4)
+
+static void check_word(unsigned long index, uint8_t device, uint16_t word) {
+    CHECK_EQ(spi_sim_log[index].device, device);
+    CHECK_EQ(spi_sim_log[index].word, word);
+}
+
+// Configuration word n as its two 16-bit halves, high half first
+static void check_config(unsigned long index, uint32_t n) {
+    check_word(index, SPI_DEVICE_ADF4351, (uint16_t)(CONFIG_WORD(n) >> 16));
+    check_word(index + 1, SPI_DEVICE_ADF4351, (uint16_t)CONFIG_WORD(n));
+}
+
+static void start_stream(void) {
+    spi_sim_reset();
+    spi_stream_start();
+}
+
+// Outside a burst a configuration word goes out at once
+static void test_idle_bus(void) {
+    spi_sim_reset();
+    spi_submit_background(SPI_DEVICE_ADF4351, CONFIG_WORD(0), 32);
+    CHECK_EQ(spi_sim_stats.words, 2);
+    check_config(0, 0);
+}
+
+// Each tick: the queued I/Q pair, then one configuration word
+static void test_tick_order(void) {
+    start_stream();
+    for(uint16_t n = 0; n < 3; n++) {
+        CHECK_EQ(spi_queue_chip(CHIP_I(n), CHIP_Q(n)), 1);
+    }
+    for(uint32_t n = 0; n < 2; n++) {
+        spi_submit_background(SPI_DEVICE_ADF4351, CONFIG_WORD(n), 32);
+    }
+    CHECK_EQ(spi_sim_stats.words, 0);           // Nothing written by the submit
+
+    for(uint16_t n = 0; n < 3; n++) {
+        spi_service_chip_tick();
+    }
+
+    // Pair, config, pair, config, pair: two 16-bit words each
+    CHECK_EQ(spi_sim_stats.words, 10);
+    check_word(0, SPI_DEVICE_MCP4922, CHIP_I(0));
+    check_word(1, SPI_DEVICE_MCP4922, CHIP_Q(0));
+    check_config(2, 0);
+    check_word(4, SPI_DEVICE_MCP4922, CHIP_I(1));
+    check_word(5, SPI_DEVICE_MCP4922, CHIP_Q(1));
+    check_config(6, 1);
+    check_word(8, SPI_DEVICE_MCP4922, CHIP_I(2));
+    check_word(9, SPI_DEVICE_MCP4922, CHIP_Q(2));
+    CHECK_EQ(spi_sim_stats.cs_conflicts, 0);
+
+    const spi_sched_stats_t* stats = spi_get_sched_stats();
+    CHECK_EQ(stats->bg_completed, 2);
+    CHECK_EQ(stats->bg_depth_max, 2);
+    CHECK_EQ(stats->chip_underruns, 0);
+    CHECK_EQ(stats->chip_depth_min, 0);
+    CHECK_EQ(spi_chip_queue_depth(), 0);
+
+    spi_stream_stop();
+}
+
+// An empty queue is an underrun while streaming, not once draining
+static void test_drain(void) {
+    const spi_sched_stats_t* stats = spi_get_sched_stats();
+
+    start_stream();
+    spi_queue_chip(CHIP_I(0), CHIP_Q(0));
+    spi_queue_chip(CHIP_I(1), CHIP_Q(1));
+    for(int n = 0; n < 4; n++) {
+        spi_service_chip_tick();
+    }
+    CHECK_EQ(stats->chip_underruns, 2);
+    spi_stream_stop();
+
+    start_stream();
+    for(uint16_t n = 0; n < 4; n++) {
+        spi_queue_chip(CHIP_I(n), CHIP_Q(n));
+    }
+    spi_service_chip_tick();
+    spi_stream_drain();
+    CHECK_EQ(spi_stream_draining_chips(), 1);
+    for(int n = 0; n < 6; n++) {
+        spi_service_chip_tick();
+    }
+    CHECK_EQ(stats->chip_underruns, 0);
+    CHECK_EQ(stats->chip_depth_min, 3);         // Only the tick before the drain
+    CHECK_EQ(spi_stream_draining_chips(), 0);
+    CHECK_EQ(spi_sim_stats.words, 8);
+    spi_stream_stop();
+}
+
+// Full background queue: the submit idles until a tick frees a slot
+static void test_stall(void) {
+    const spi_sched_stats_t* stats = spi_get_sched_stats();
+
+    start_stream();
+    spi_sim_set_idle_hook(spi_service_chip_tick);
+    for(uint32_t n = 0; n < SPI_BG_QUEUE_SIZE; n++) {
+        spi_submit_background(SPI_DEVICE_ADF4351, CONFIG_WORD(n), 32);
+    }
+    CHECK_EQ(stats->bg_stalls, 0);
+    CHECK_EQ(spi_sim_stats.idles, 0);
+
+    spi_submit_background(SPI_DEVICE_ADF4351, CONFIG_WORD(SPI_BG_QUEUE_SIZE), 32);
+    CHECK_EQ(stats->bg_stalls, 1);
+    CHECK_EQ(spi_sim_stats.idles, 1);
+    CHECK_EQ(stats->bg_completed, 1);
+    CHECK_EQ(stats->bg_depth_max, SPI_BG_QUEUE_SIZE);
+
+    // Every word still goes out once, in submit order
+    spi_sim_set_idle_hook(NULL);
+    spi_stream_stop();
+    CHECK_EQ(spi_sim_stats.words, 2 * (SPI_BG_QUEUE_SIZE + 1));
+    for(uint32_t n = 0; n <= SPI_BG_QUEUE_SIZE; n++) {
+        check_config(2 * n, n);
+    }
+}
+
+// Stop writes the queued configuration words in order and empties the
+// chip queue without shifting its pairs out
+static void test_stop_flush(void) {
+    start_stream();
+    spi_queue_chip(CHIP_I(0), CHIP_Q(0));
+    for(uint32_t n = 0; n < 3; n++) {
+        spi_submit_background(SPI_DEVICE_ADF4351, CONFIG_WORD(n), 32);
+    }
+    spi_stream_stop();
+
+    CHECK_EQ(spi_stream_active(), 0);
+    CHECK_EQ(spi_chip_queue_depth(), 0);
+    CHECK_EQ(spi_get_sched_stats()->bg_completed, 3);
+    CHECK_EQ(spi_sim_stats.words, 6);
+    for(uint32_t n = 0; n < 3; n++) {
+        check_config(2 * n, n);
+    }
+
+    // Nothing left for the next burst
+    start_stream();
+    spi_service_chip_tick();
+    CHECK_EQ(spi_sim_stats.words, 0);
+    spi_stream_stop();
+}
+
+int main(void) {
+    test_idle_bus();
+    test_tick_order();
+    test_drain();
+    test_stall();
+    test_stop_flush();
+    return host_report("test_spi_sched");
+}